@@ -22,6 +22,10 @@ __all__ = [
     "Criterion",
     "ParallelCriterion",
     "SequentialCriterion",
+    "Executor",
+    "CancellationToken",
+    "FileChunksReader",
+    "CallbackChunksReader",
     "Combi",
     "Multi",
     "Mia",
@@ -52,6 +56,9 @@ class Solver(DocEnum):
     FAST = _gmdh_core.Solver.FAST.value, "Fast solution with perhaps not the best accuracy"
     ACCURATE = _gmdh_core.Solver.ACCURATE.value, 'Slow solution with maximum accuracy'
     BALANCED = _gmdh_core.Solver.BALANCED.value, 'Balanced solution with average speed and accuracy'
+    GRAM = _gmdh_core.Solver.GRAM.value, "The fastest solution using the precomputed Gram matrix of the data"
+    ADAPTIVE = _gmdh_core.Solver.ADAPTIVE.value, \
+        "Fast solution that switches to the pivoting decompositions only for the badly conditioned combinations"
 
 class PolynomialType(DocEnum):
     """
@@ -80,6 +87,10 @@ class CriterionType(DocEnum):
     UNBIASED_COEFFS = _gmdh_core.CriterionType.UNBIASED_COEFFS.value, ""
     ABSOLUTE_NOISE_IMMUNITY = _gmdh_core.CriterionType.ABSOLUTE_NOISE_IMMUNITY.value, ""
     SYM_ABSOLUTE_NOISE_IMMUNITY = _gmdh_core.CriterionType.SYM_ABSOLUTE_NOISE_IMMUNITY.value, ""
+    CROSS_VALIDATION = _gmdh_core.CriterionType.CROSS_VALIDATION.value, \
+        "5-fold cross-validation computed from the fold statistics without refitting the combinations"
+    LEAVE_ONE_OUT = _gmdh_core.CriterionType.LEAVE_ONE_OUT.value, \
+        "Leave-one-out error (PRESS) computed from the hat matrix diagonal of one decomposition of the learning data"
 
 
 class Criterion:
@@ -276,14 +287,20 @@ class SequentialCriterion(Criterion):
     top : int, default=0
         The number of the best combinations that should be evaluated by the second criterion.
         If the parameter value equals to 0, about half of the combinations
-        will remain for the second criterion.
+        will remain for the second criterion. The remaining combinations are kept
+        in memory until all combinations of the level are evaluated.
     solver : gmdh.Solver, default=gmdh.Solver.BALANCED
         Element from `gmdh.Solver` enumeration specifying the method of
         linear equations solving during training GMDH model.
+    top_limit : int, default=0
+        The maximum number of the combinations remaining for the second criterion if top=0.
+        It bounds the memory of the levels with many combinations, but the selected combinations
+        can differ from the ones selected without the limit. If `k_best` is greater, `k_best`
+        combinations remain. If top_limit=0 the number of the combinations isn't limited.
 
     Attributes
     ----------
-    criterion_type, second_criterion_type, top, solver : see Parameters
+    criterion_type, second_criterion_type, top, solver, top_limit : see Parameters
 
     Examples
     --------
@@ -312,12 +329,15 @@ second_criterion_type=gmdh.CriterionType.REGULARITY, top=7, solver=gmdh.Solver.F
     0
     >>> criterion.solver
     <Solver.BALANCED: 2>
+    >>> criterion.top_limit
+    0
     """
     def __init__(self,
         criterion_type=CriterionType.REGULARITY,
         second_criterion_type=CriterionType.STABILITY,
         top=0,
-        solver=Solver.BALANCED):
+        solver=Solver.BALANCED,
+        top_limit=0):
 
         super().__init__(criterion_type, solver)
         if not isinstance(second_criterion_type, CriterionType):
@@ -326,9 +346,14 @@ second_criterion_type=gmdh.CriterionType.REGULARITY, top=7, solver=gmdh.Solver.F
             raise TypeError(f"{top} is not an 'int' type object")
         if top < 0:
             raise ValueError("top value must be a non-negative")
+        if not isinstance(top_limit, int):
+            raise TypeError(f"{top_limit} is not an 'int' type object")
+        if top_limit < 0:
+            raise ValueError("top_limit value must be a non-negative")
 
         self._second_criterion_type = second_criterion_type
         self._top = top
+        self._top_limit = top_limit
 
     @property
     def second_criterion_type(self):  # pylint: disable=missing-function-docstring
@@ -352,12 +377,195 @@ second_criterion_type=gmdh.CriterionType.REGULARITY, top=7, solver=gmdh.Solver.F
             raise ValueError("top value must be a non-negative")
         self._top = value
 
+    @property
+    def top_limit(self):  #pylint: disable=missing-function-docstring
+        return self._top_limit
+
+    @top_limit.setter
+    def top_limit(self, value):
+        if not isinstance(value, int):
+            raise TypeError(f"{value} is not an 'int' type object")
+        if value < 0:
+            raise ValueError("top_limit value must be a non-negative")
+        self._top_limit = value
+
     def _get_core(self):
         return  _gmdh_core.SequentialCriterion(
             _gmdh_core.CriterionType(self._criterion_type.value),
             _gmdh_core.CriterionType(self._second_criterion_type.value),
             self._top,
-            _gmdh_core.Solver(self._solver.value))
+            _gmdh_core.Solver(self._solver.value),
+            self._top_limit)
+
+class Executor:
+    """
+    Class of the thread pool that can be created once and shared by the fitting of several models.
+
+    Parameters
+    ----------
+    n_jobs : int, default=-1
+        The number of threads of the pool.
+        If n_jobs=-1 the maximum possible threads will be used.
+
+    Attributes
+    ----------
+    n_jobs : int
+        The number of threads of the pool.
+
+    Examples
+    --------
+    Fitting several models using the same threads:
+
+    >>> executor = gmdh.Executor(n_jobs=4)
+    >>> model = gmdh.Combi()
+    >>> model.fit(X, y, n_jobs=-1, executor=executor)
+    >>> model = gmdh.Multi()
+    >>> model.fit(X, y, n_jobs=-1, executor=executor)
+
+    The fittings started concurrently share the threads of the pool fairly.
+    The fitting methods release the GIL, so the fittings can be started by several Python threads.
+    The progress callbacks and the chunk readers are called with the GIL held.
+    """
+    def __init__(self, n_jobs=-1):
+        self._executor = _gmdh_core.Executor(n_jobs)
+
+    @property
+    def n_jobs(self):  # pylint: disable=missing-function-docstring
+        return self._executor.get_threads_number()
+
+    def _get_core(self):
+        return self._executor
+
+class CancellationToken:
+    """
+    Class of the token stopping the fitting of models after the deadline or on request.
+
+    After the cancellation the current level is finished with the already evaluated combinations
+    and its best combinations are kept only if they improve the previous level.
+    The model stays valid and the `truncated` attribute of its `get_fit_report` result is True.
+
+    Parameters
+    ----------
+    time_limit : float, default=-1
+        The time in seconds from the token creation after which the token is cancelled.
+        If time_limit=-1 the token is cancelled only by the `cancel` method.
+
+    Examples
+    --------
+    Fitting the model no longer than 10 seconds:
+
+    >>> model = gmdh.Combi()
+    >>> model.fit(X, y, token=gmdh.CancellationToken(time_limit=10))
+    >>> model.get_fit_report().truncated
+    False
+
+    Stopping the fitting from the progress callback:
+
+    >>> token = gmdh.CancellationToken()
+    >>> model.set_progress_callback(lambda info: token.cancel() if info.level > 3 else None)
+    >>> model.fit(X, y, token=token)
+    """
+    def __init__(self, time_limit=-1):
+        self._token = _gmdh_core.CancellationToken(time_limit)
+
+    def cancel(self):
+        """
+        Requesting the cancellation of the fitting processes using the token.
+        """
+        self._token.cancel()
+
+    def is_cancelled(self):
+        """
+        Checking whether the fitting processes using the token should be stopped.
+
+        Returns
+        -------
+        cancelled : bool
+            True if the cancellation is requested or the time limit has expired.
+        """
+        return self._token.is_cancelled()
+
+    def _get_core(self):
+        return self._token
+
+class FileChunksReader:
+    """
+    Class of the reader passing the rows of the binary file to `fit_chunks` methods in chunks.
+
+    The file is mapped into memory one chunk at a time, so it can be larger than the memory.
+    Each row of the file contains `cols_number` float64 values of the input features
+    followed by the float64 target value, the rows are written one after another.
+
+    Parameters
+    ----------
+    path : str
+        The path to the file.
+    cols_number : int
+        The number of the input features in each row.
+    chunk_rows : int, default=65536
+        The number of rows mapped into memory at once.
+
+    Examples
+    --------
+    Writing the data to the file and fitting the model on it:
+
+    >>> np.hstack([X, np.reshape(y, (-1, 1))]).astype(np.float64).tofile('data.bin')
+    >>> model = gmdh.Combi()
+    >>> model.fit_chunks(gmdh.FileChunksReader('data.bin', cols_number=X.shape[1]))
+    """
+    def __init__(self, path, cols_number, chunk_rows=65536):
+        try:
+            self._reader = _gmdh_core.FileChunksReader(path, cols_number, chunk_rows)
+        except _gmdh_core.FileError as err:
+            raise FileError(err.args[0]) from err
+
+    def _get_core(self):
+        return self._reader
+
+class CallbackChunksReader:
+    """
+    Class of the reader passing the chunks of rows produced by the python function to `fit_chunks` methods.
+
+    The data is read once to count its rows if `n_rows` isn't given. Then it is read once
+    for the internal train and test sets of Combi and Multi models and once per level
+    for Mia and Ria models, so the function is called each time the data is read again.
+
+    Parameters
+    ----------
+    chunks : callable
+        The function without arguments returning the iterable of (X, y) pairs of numpy arrays.
+        All chunks must have the same number of columns.
+    n_rows : int, default=None
+        The number of the data rows. If it is given, only the first chunk is read
+        to find the number of columns instead of the pass over all chunks.
+        It must be equal to the total number of rows of all chunks.
+
+    Examples
+    --------
+    Reading the rows from several files:
+
+    >>> reader = gmdh.CallbackChunksReader(lambda: ((np.load(f'X{i}.npy'), np.load(f'y{i}.npy')) for i in range(10)))
+    >>> model = gmdh.Mia()
+    >>> model.fit_chunks(reader)
+    """
+    def __init__(self, chunks, n_rows=None):
+        self._chunks = chunks
+        self._iterator = None
+        self._reader = _gmdh_core.CallbackChunksReader(self._rewind, self._read, -1 if n_rows is None else n_rows)
+
+    def _rewind(self):
+        self._iterator = iter(self._chunks())
+
+    def _read(self):
+        for x_chunk, y_chunk in self._iterator:
+            x_chunk = np.array(x_chunk, dtype=np.float64, ndmin=2)
+            y_chunk = np.array(y_chunk, dtype=np.float64).ravel()
+            if x_chunk.shape[0] > 0:
+                return x_chunk, y_chunk
+        return np.empty((0, 0)), np.empty(0)
+
+    def _get_core(self):
+        return self._reader
 
 class Meta(ABCMeta, NumpyDocstringInheritanceMeta):
     """
@@ -365,6 +573,18 @@ class Meta(ABCMeta, NumpyDocstringInheritanceMeta):
     to provide posiibility avoiding writing duplicated docstrings.
     """
 
+def _expired_rows(X, expired_X, expired_y):  # pylint: disable=invalid-name
+    """
+    Replacing the missing expired rows of `partial_fit` methods with the empty arrays.
+    """
+    if expired_X is None and expired_y is None:
+        return np.empty((0, np.shape(X)[1])), np.empty(0)
+    if expired_X is None or expired_y is None:
+        raise ValueError('expired_X and expired_y must be set together')
+    if np.isnan(expired_X).sum() > 0 or np.isnan(expired_y).sum() > 0:
+        raise ValueError('expired arrays contain nan values')
+    return expired_X, expired_y
+
 class Model(metaclass=Meta):
     """
     Abstract class that provides model interfaces and
@@ -438,6 +658,110 @@ class Model(metaclass=Meta):
         """
         return self._model.get_best_polynomial()
 
+    def get_fit_report(self):
+        """
+        Getting the statistics of the last fitting process.
+
+        Returns
+        -------
+        report : FitReport
+            Object whose `evaluated_combinations` and `pruned_combinations` attributes
+            contain the numbers of evaluated and skipped combinations at each level.
+            Its `escalated_combinations` attribute contains the numbers of combinations at each level
+            solved by the pivoting decompositions after the check of `Solver.ADAPTIVE`. Each combination
+            is counted once, and the screened ones trained again on all data rows are counted once more.
+            Its `truncated` attribute is True if the fitting was stopped by the cancellation token.
+            Its `screening_recall` attribute contains the estimated fraction of the best combinations
+            of each level that passed the screening set up by `set_screening` method.
+            Its `criteria_scores` attribute contains a matrix for each level whose rows are the combinations
+            of the level and columns are the values of the criteria set up by `set_scored_criteria` method.
+            The rows of the not evaluated combinations contain NaN.
+        """
+        return self._model.get_fit_report()
+
+    def set_progress_callback(self, callback):
+        """
+        Setting the function receiving the progress of the next fitting processes.
+
+        The function is called every 0.2 seconds during each level
+        and once after the level is completed.
+
+        Parameters
+        ----------
+        callback : callable or None
+            Function taking one `ProgressInfo` object whose `level`, `combinations_number`,
+            `done_combinations`, `throughput` (combinations per second), `best_evaluation`
+            and `level_completed` attributes describe the progress of the current level.
+            If callback=None the progress won't be reported.
+
+        Examples
+        --------
+        >>> model = gmdh.Combi()
+        >>> model.set_progress_callback(lambda info: print(info.level, info.done_combinations))
+        """
+        if callback is not None and not callable(callback):
+            raise TypeError(f"{callback} is not a callable object")
+        self._model.set_progress_callback(callback)
+
+    def set_screening(self, rows_fraction=1.0, survivors=0):
+        """
+        Setting up the two-stage evaluation of combinations for the next fitting processes.
+
+        All combinations of the level are screened on a random subset of the data rows,
+        then the `survivors` best of them are evaluated again on all data rows
+        and the combinations of the next level are selected by these errors.
+        It speeds up the fitting on very tall data. It doesn't affect `gmdh.Solver.GRAM`.
+
+        Parameters
+        ----------
+        rows_fraction : float, default=1.0
+            Fraction of the data rows used for the screening.
+            Value must be in the (0, 1] range. If rows_fraction=1 the screening isn't used.
+        survivors : int, default=0
+            The number of screened combinations evaluated again on all data rows.
+            It is increased to the number of combinations selected at the level if it is less.
+
+        Examples
+        --------
+        >>> model = gmdh.Combi()
+        >>> model.set_screening(rows_fraction=0.1, survivors=100)
+        """
+        if not isinstance(rows_fraction, (int, float)):
+            raise TypeError(f"{rows_fraction} is not a float")
+        if not isinstance(survivors, int):
+            raise TypeError(f"{survivors} is not an int")
+        if survivors < 0:
+            raise ValueError("survivors value must be a non-negative integer")
+        try:
+            self._model.set_screening(rows_fraction, survivors)
+        except ValueError as err:
+            raise ValueError(err.args[0]) from err
+
+    def set_scored_criteria(self, criteria):
+        """
+        Setting the criteria whose values are calculated for all combinations by the next fitting processes.
+
+        The values are calculated in the same pass as the selecting criterion
+        reusing the already calculated coefficients and are returned by `get_fit_report` method.
+        They don't affect the selection of the combinations.
+
+        Parameters
+        ----------
+        criteria : list of gmdh.CriterionType
+            Elements from `gmdh.CriterionType` enumeration. Empty list disables the scoring.
+
+        Examples
+        --------
+        >>> model = gmdh.Combi()
+        >>> model.set_scored_criteria([gmdh.CriterionType.REGULARITY, gmdh.CriterionType.LEAVE_ONE_OUT])
+        """
+        if not isinstance(criteria, (list, tuple)):
+            raise TypeError(f"{criteria} is not a list")
+        for criterion_type in criteria:
+            if not isinstance(criterion_type, CriterionType):
+                raise TypeError(f"{criterion_type} is not a 'CriterionType' type object")
+        self._model.set_scored_criteria([_gmdh_core.CriterionType(criterion_type.value) for criterion_type in criteria])
+
     def save(self, path):
         """
         Saving fitted model to the file.
@@ -496,13 +820,15 @@ class Combi(Model):
     from simple to complex ones. Each combination is a linear function.\n
     Combinations at the first level: y = w0 + w1*x1.\n
     Combinations at the second level: y = w0 + w1*x1 + w2*x2.\n
-    Combinations at the N-th level: y = w0 + w1*x1 + w2*x2 + ... + wn*xn.
+    Combinations at the N-th level: y = w0 + w1*x1 + w2*x2 + ... + wn*xn.\n
+    With `gmdh.Solver.GRAM` each combination reuses the decomposition of its parent
+    extended by one variable, that is the fastest search for data with more than 20 variables.
     """
     def __init__(self):
         super().__init__(_gmdh_core.Combi())
 
     def fit(self, X, y, criterion=Criterion(CriterionType.REGULARITY), test_size=0.5,  # pylint: disable=invalid-name
-        p_average=1, n_jobs=1, verbose=0, limit=0):
+        p_average=1, n_jobs=1, verbose=0, limit=0, pruning=False, executor=None, token=None):
         """
         Fitting the Combi model to find the best solution.
 
@@ -533,6 +859,18 @@ class Combi(Model):
         limit : float, default=0
             If the error value at the end of the level decreases by less then limit value
             compared to the previous level the training process will stop.
+        pruning : bool, default=False
+            If pruning=True then the combinations that can't be better than the already found ones
+            are skipped by the branch-and-bound search. The found combinations are the same as without pruning.
+            It requires `gmdh.Solver.GRAM` and the regularity or stability criterion.
+            The numbers of skipped combinations are returned by `get_fit_report` method.
+        executor : gmdh.Executor, default=None
+            The thread pool shared with the fitting of other models.
+            If executor=None the threads are created only for this fitting.
+            If n_jobs=-1 all threads of the executor will be used.
+        token : gmdh.CancellationToken, default=None
+            The token stopping the fitting after its time limit or on request.
+            The stopped fitting returns the model built from the already evaluated combinations.
 
         Returns
         -------
@@ -540,7 +878,124 @@ class Combi(Model):
             Fitted model.
         """
         super().fit(X, y)
-        self._model.fit(X, y, criterion._get_core(), test_size, p_average, n_jobs, verbose, limit)
+        self._model.fit(X, y, criterion._get_core(), test_size, p_average, n_jobs, verbose, limit, pruning,
+            executor._get_core() if executor is not None else None,
+            token._get_core() if token is not None else None)
+        return self
+
+    def partial_fit(self, X, y, criterion=Criterion(CriterionType.REGULARITY, Solver.GRAM),  # pylint: disable=invalid-name
+        test_size=0.5, p_average=1, n_jobs=1, verbose=0, limit=0, pruning=False,
+        expired_X=None, expired_y=None, executor=None, token=None):  # pylint: disable=invalid-name
+        """
+        Fitting the Combi model using all rows appended by the previous calls and the new ones.
+
+        The model doesn't keep the data rows, only the statistics of the internal train and test sets
+        are updated by the new rows and optionally by the expired ones,
+        so the cost of the update depends only on the number of these rows.
+        The test rows are spread evenly over the appended rows.
+        The statistics are kept between the calls independently of `fit` method.
+
+        Parameters
+        ----------
+        X : array_like
+            2D array containing the new numeric training data rows.
+        y : array_like
+            1D array containg target numeric values for the new rows.
+        criterion : gmdh.Criterion, default=gmdh.Criterion(gmdh.CriterionType.REGULARITY, gmdh.Solver.GRAM)
+            External criterion. It must use `gmdh.Solver.GRAM` and can't use
+            `gmdh.CriterionType.CROSS_VALIDATION` and `gmdh.CriterionType.LEAVE_ONE_OUT`.
+        test_size : float, default=0.5
+            Proportion of the rows included in the internal test set.
+            It must be the same for all calls.
+        p_average : int, default=1
+            Specifying the number of the best combinations for calculation
+            the mean error value at each level.
+        n_jobs : int, default=1
+            The number of threads that will be used for calculations.
+        verbose : {0, 1}, default=0
+            If verbose=1 then the progress bars will be displayed during the model fitting.
+        limit : float, default=0
+            If the error value at the end of the level decreases by less then limit value
+            compared to the previous level the training process will stop.
+        pruning : bool, default=False
+            If pruning=True then the combinations that can't be better than the already found ones
+            are skipped by the branch-and-bound search.
+        expired_X : array_like, default=None
+            2D array containing the oldest previously appended rows that must be removed
+            from the accumulated statistics, in their original order. It is used for the sliding window.
+        expired_y : array_like, default=None
+            1D array containing target values for the `expired_X` rows.
+        executor : gmdh.Executor, default=None
+            The thread pool shared with the fitting of other models.
+        token : gmdh.CancellationToken, default=None
+            The token stopping the fitting after its time limit or on request.
+
+        Returns
+        -------
+        self : Combi
+            Fitted model.
+
+        Examples
+        --------
+        Fitting the model on the first rows of Fibonacci series,
+        then appending two new rows and removing two oldest ones:
+
+        >>> X, y = gmdh.time_series_transformation([1, 1, 2, 3, 5, 8, 13, 21, 34, 55], lags=2)
+        >>> model = gmdh.Combi()
+        >>> model.partial_fit(X[:6], y[:6])  # doctest: +ELLIPSIS
+        <gmdh.gmdh.Combi object at 0x...>
+        >>> model.partial_fit(X[6:], y[6:], expired_X=X[:2], expired_y=y[:2])  # doctest: +ELLIPSIS
+        <gmdh.gmdh.Combi object at 0x...>
+        """
+        super().fit(X, y)
+        expired_X, expired_y = _expired_rows(X, expired_X, expired_y)
+        self._model.partial_fit(X, y, criterion._get_core(), test_size, p_average, n_jobs, verbose, limit, pruning,
+            expired_X, expired_y, executor._get_core() if executor is not None else None,
+            token._get_core() if token is not None else None)
+        return self
+
+    def fit_chunks(self, reader, criterion=Criterion(CriterionType.REGULARITY, Solver.GRAM),
+        test_size=0.5, p_average=1, n_jobs=1, verbose=0, limit=0, pruning=False, executor=None, token=None):
+        """
+        Fitting the Combi model on the data read in chunks without loading all rows into memory.
+
+        The statistics of the internal train and test sets are accumulated chunk by chunk,
+        the first rows form the train set and the last `test_size` rows form the test set as in `fit` method.
+
+        Parameters
+        ----------
+        reader : gmdh.FileChunksReader or gmdh.CallbackChunksReader
+            The source of the data rows.
+        criterion : gmdh.Criterion, default=gmdh.Criterion(gmdh.CriterionType.REGULARITY, gmdh.Solver.GRAM)
+            External criterion. It must use `gmdh.Solver.GRAM` and can't use `gmdh.CriterionType.LEAVE_ONE_OUT`.
+        test_size : float, default=0.5
+            Proportion of the last rows included in the internal test set.
+        p_average : int, default=1
+            Specifying the number of the best combinations for calculation
+            the mean error value at each level.
+        n_jobs : int, default=1
+            The number of threads that will be used for calculations.
+        verbose : {0, 1}, default=0
+            If verbose=1 then the progress bars will be displayed during the model fitting.
+        limit : float, default=0
+            If the error value at the end of the level decreases by less then limit value
+            compared to the previous level the training process will stop.
+        pruning : bool, default=False
+            If pruning=True then the combinations that can't be better than the already found ones
+            are skipped by the branch-and-bound search.
+        executor : gmdh.Executor, default=None
+            The thread pool shared with the fitting of other models.
+        token : gmdh.CancellationToken, default=None
+            The token stopping the fitting after its time limit or on request.
+
+        Returns
+        -------
+        self : Combi
+            Fitted model.
+        """
+        self._model.fit_chunks(reader._get_core(), criterion._get_core(), test_size, p_average, n_jobs, verbose,
+            limit, pruning, executor._get_core() if executor is not None else None,
+            token._get_core() if token is not None else None)
         return self
 
     def predict(self, X, lags=None):  # pylint: disable=invalid-name
@@ -645,12 +1100,15 @@ class Multi(Model):
     y = f(x3, x1)\n
     y = f(x3, x4)\n
     At each level, one new variable will be added to the best combinations.
+    The decomposition of each new combination is obtained by appending one column
+    to the decomposition of its parent for `gmdh.Solver.FAST` and `gmdh.Solver.GRAM`;
+    the pivoting solvers decompose each combination anew.
     """
     def __init__(self):
         super().__init__(_gmdh_core.Multi())
 
     def fit(self, X, y, criterion=Criterion(CriterionType.REGULARITY), k_best=1, test_size=0.5,
-        p_average=1, n_jobs=1, verbose=0, limit=0):
+        p_average=1, n_jobs=1, verbose=0, limit=0, executor=None, token=None):
         """
         Fitting the Multi model to find the best solution.
 
@@ -684,6 +1142,13 @@ class Multi(Model):
         limit : float, default=0
             If the error value at the end of the level decreases by less then limit value
             compared to the previous level the training process will stop.
+        executor : gmdh.Executor, default=None
+            The thread pool shared with the fitting of other models.
+            If executor=None the threads are created only for this fitting.
+            If n_jobs=-1 all threads of the executor will be used.
+        token : gmdh.CancellationToken, default=None
+            The token stopping the fitting after its time limit or on request.
+            The stopped fitting returns the model built from the already evaluated combinations.
 
         Returns
         -------
@@ -692,7 +1157,112 @@ class Multi(Model):
         """
         super().fit(X, y)
         self._model.fit(X, y, criterion._get_core(), k_best, test_size, p_average,
-            n_jobs, verbose, limit)
+            n_jobs, verbose, limit, executor._get_core() if executor is not None else None,
+            token._get_core() if token is not None else None)
+        return self
+
+    def partial_fit(self, X, y, criterion=Criterion(CriterionType.REGULARITY, Solver.GRAM),  # pylint: disable=invalid-name
+        k_best=1, test_size=0.5, p_average=1, n_jobs=1, verbose=0, limit=0,
+        expired_X=None, expired_y=None, executor=None, token=None):  # pylint: disable=invalid-name
+        """
+        Fitting the Multi model using all rows appended by the previous calls and the new ones.
+
+        The model doesn't keep the data rows, only the statistics of the internal train and test sets
+        are updated by the new rows and optionally by the expired ones,
+        so the cost of the update depends only on the number of these rows.
+        The test rows are spread evenly over the appended rows.
+        The statistics are kept between the calls independently of `fit` method.
+
+        Parameters
+        ----------
+        X : array_like
+            2D array containing the new numeric training data rows.
+        y : array_like
+            1D array containg target numeric values for the new rows.
+        criterion : gmdh.Criterion, default=gmdh.Criterion(gmdh.CriterionType.REGULARITY, gmdh.Solver.GRAM)
+            External criterion. It must use `gmdh.Solver.GRAM` and can't use
+            `gmdh.CriterionType.CROSS_VALIDATION` and `gmdh.CriterionType.LEAVE_ONE_OUT`.
+        k_best : int, default=1
+            The number of best combinations at each level that will be combined
+            with other unused features (or lags) at the next level.
+        test_size : float, default=0.5
+            Proportion of the rows included in the internal test set.
+            It must be the same for all calls.
+        p_average : int, default=1
+            Specifying the number of the best combinations for calculation
+            the mean error value at each level.
+        n_jobs : int, default=1
+            The number of threads that will be used for calculations.
+        verbose : {0, 1}, default=0
+            If verbose=1 then the progress bars will be displayed during the model fitting.
+        limit : float, default=0
+            If the error value at the end of the level decreases by less then limit value
+            compared to the previous level the training process will stop.
+        expired_X : array_like, default=None
+            2D array containing the oldest previously appended rows that must be removed
+            from the accumulated statistics, in their original order. It is used for the sliding window.
+        expired_y : array_like, default=None
+            1D array containing target values for the `expired_X` rows.
+        executor : gmdh.Executor, default=None
+            The thread pool shared with the fitting of other models.
+        token : gmdh.CancellationToken, default=None
+            The token stopping the fitting after its time limit or on request.
+
+        Returns
+        -------
+        self : Multi
+            Fitted model.
+        """
+        super().fit(X, y)
+        expired_X, expired_y = _expired_rows(X, expired_X, expired_y)
+        self._model.partial_fit(X, y, criterion._get_core(), k_best, test_size, p_average,
+            n_jobs, verbose, limit, expired_X, expired_y,
+            executor._get_core() if executor is not None else None,
+            token._get_core() if token is not None else None)
+        return self
+
+    def fit_chunks(self, reader, criterion=Criterion(CriterionType.REGULARITY, Solver.GRAM), k_best=1,
+        test_size=0.5, p_average=1, n_jobs=1, verbose=0, limit=0, executor=None, token=None):
+        """
+        Fitting the Multi model on the data read in chunks without loading all rows into memory.
+
+        The statistics of the internal train and test sets are accumulated chunk by chunk,
+        the first rows form the train set and the last `test_size` rows form the test set as in `fit` method.
+
+        Parameters
+        ----------
+        reader : gmdh.FileChunksReader or gmdh.CallbackChunksReader
+            The source of the data rows.
+        criterion : gmdh.Criterion, default=gmdh.Criterion(gmdh.CriterionType.REGULARITY, gmdh.Solver.GRAM)
+            External criterion. It must use `gmdh.Solver.GRAM` and can't use `gmdh.CriterionType.LEAVE_ONE_OUT`.
+        k_best : int, default=1
+            The number of best combinations at each level that will be combined
+            with other unused features (or lags) at the next level.
+        test_size : float, default=0.5
+            Proportion of the last rows included in the internal test set.
+        p_average : int, default=1
+            Specifying the number of the best combinations for calculation
+            the mean error value at each level.
+        n_jobs : int, default=1
+            The number of threads that will be used for calculations.
+        verbose : {0, 1}, default=0
+            If verbose=1 then the progress bars will be displayed during the model fitting.
+        limit : float, default=0
+            If the error value at the end of the level decreases by less then limit value
+            compared to the previous level the training process will stop.
+        executor : gmdh.Executor, default=None
+            The thread pool shared with the fitting of other models.
+        token : gmdh.CancellationToken, default=None
+            The token stopping the fitting after its time limit or on request.
+
+        Returns
+        -------
+        self : Multi
+            Fitted model.
+        """
+        self._model.fit_chunks(reader._get_core(), criterion._get_core(), k_best, test_size, p_average,
+            n_jobs, verbose, limit, executor._get_core() if executor is not None else None,
+            token._get_core() if token is not None else None)
         return self
 
     def predict(self, X, lags=None):  # pylint: disable=invalid-name
@@ -799,14 +1369,16 @@ class Mia(Model):
     y = f4(f1, f2)\n
     y = f5(f1, f3)\n
     y = f6(f2, f3)\n
-    At each level, new combinations are constructed from the best polynomials of the last level.
+    At each level, new combinations are constructed from the best polynomials of the last level.\n
+    With `gmdh.Solver.GRAM` the sums of products of the powered variables are calculated once per level,
+    so the evaluation of each polynomial doesn't depend on the number of data rows.
     """
     def __init__(self):
         super().__init__(_gmdh_core.Mia())
 
     def fit(self, X, y, criterion=Criterion(CriterionType.REGULARITY), k_best=3,
         polynomial_type=PolynomialType.QUADRATIC,
-        test_size=0.5, p_average=1, n_jobs=1, verbose=0, limit=0):
+        test_size=0.5, p_average=1, n_jobs=1, verbose=0, limit=0, executor=None, token=None):
         """
         Fitting the Mia model to find the best solution.
 
@@ -843,6 +1415,13 @@ class Mia(Model):
         limit : float, default=0
             If the error value at the end of the level decreases by less then limit value
             compared to the previous level the training process will stop.
+        executor : gmdh.Executor, default=None
+            The thread pool shared with the fitting of other models.
+            If executor=None the threads are created only for this fitting.
+            If n_jobs=-1 all threads of the executor will be used.
+        token : gmdh.CancellationToken, default=None
+            The token stopping the fitting after its time limit or on request.
+            The stopped fitting returns the model built from the already evaluated combinations.
 
         Returns
         -------
@@ -852,7 +1431,58 @@ class Mia(Model):
         super().fit(X, y)
         self._model.fit(X, y, criterion._get_core(), k_best,
             _gmdh_core.PolynomialType(polynomial_type.value), test_size,
-            p_average, n_jobs, verbose, limit)
+            p_average, n_jobs, verbose, limit, executor._get_core() if executor is not None else None,
+            token._get_core() if token is not None else None)
+        return self
+
+    def fit_chunks(self, reader, criterion=Criterion(CriterionType.REGULARITY, Solver.GRAM), k_best=3,
+        polynomial_type=PolynomialType.QUADRATIC,
+        test_size=0.5, p_average=1, n_jobs=1, verbose=0, limit=0, executor=None, token=None):
+        """
+        Fitting the Mia model on the data read in chunks without loading all rows into memory.
+
+        The statistics of the internal train and test sets are accumulated chunk by chunk,
+        the first rows form the train set and the last `test_size` rows form the test set as in `fit` method.
+        The data is read once more at each level to calculate the outputs of the previous levels.
+
+        Parameters
+        ----------
+        reader : gmdh.FileChunksReader or gmdh.CallbackChunksReader
+            The source of the data rows.
+        criterion : gmdh.Criterion, default=gmdh.Criterion(gmdh.CriterionType.REGULARITY, gmdh.Solver.GRAM)
+            External criterion. It must use `gmdh.Solver.GRAM` and can't use `gmdh.CriterionType.LEAVE_ONE_OUT`.
+        k_best : int, default=3
+            The number of best combinations at each level that will be combined
+            with other unused features (or lags) at the next level.
+            The minimum allowed value is 3.
+        polynomial_type : gmdh.PolynomialType, default=gmdh.PolynomialType.QUADRATIC
+            Specifying the type of polynomials that will be used to construct the final polynomial.
+        test_size : float, default=0.5
+            Proportion of the last rows included in the internal test set.
+        p_average : int, default=1
+            Specifying the number of the best combinations for calculation
+            the mean error value at each level.
+        n_jobs : int, default=1
+            The number of threads that will be used for calculations.
+        verbose : {0, 1}, default=0
+            If verbose=1 then the progress bars will be displayed during the model fitting.
+        limit : float, default=0
+            If the error value at the end of the level decreases by less then limit value
+            compared to the previous level the training process will stop.
+        executor : gmdh.Executor, default=None
+            The thread pool shared with the fitting of other models.
+        token : gmdh.CancellationToken, default=None
+            The token stopping the fitting after its time limit or on request.
+
+        Returns
+        -------
+        self : Mia
+            Fitted model.
+        """
+        self._model.fit_chunks(reader._get_core(), criterion._get_core(), k_best,
+            _gmdh_core.PolynomialType(polynomial_type.value), test_size,
+            p_average, n_jobs, verbose, limit, executor._get_core() if executor is not None else None,
+            token._get_core() if token is not None else None)
         return self
 
     def predict(self, X, lags=None):  # pylint: disable=invalid-name
@@ -985,14 +1615,16 @@ class Ria(Model):
     y = f7(f2, x2)\n
     y = f8(f2, x3)\n
     At each level, new combinations are constructed from the best polynomials
-    of the last level and the original variables.
+    of the last level and the original variables.\n
+    With `gmdh.Solver.GRAM` the sums of products of the powered variables are calculated once per level,
+    so the evaluation of each polynomial doesn't depend on the number of data rows.
     """
     def __init__(self):
         super().__init__(_gmdh_core.Ria())
 
     def fit(self, X, y, criterion=Criterion(CriterionType.REGULARITY), k_best=1,
         polynomial_type=PolynomialType.QUADRATIC,
-        test_size=0.5, p_average=1, n_jobs=1, verbose=0, limit=0):
+        test_size=0.5, p_average=1, n_jobs=1, verbose=0, limit=0, executor=None, token=None):
         """
         Fitting the Ria model to find the best solution.
 
@@ -1028,6 +1660,13 @@ class Ria(Model):
         limit : float, default=0
             If the error value at the end of the level decreases by less then limit value
             compared to the previous level the training process will stop.
+        executor : gmdh.Executor, default=None
+            The thread pool shared with the fitting of other models.
+            If executor=None the threads are created only for this fitting.
+            If n_jobs=-1 all threads of the executor will be used.
+        token : gmdh.CancellationToken, default=None
+            The token stopping the fitting after its time limit or on request.
+            The stopped fitting returns the model built from the already evaluated combinations.
 
         Returns
         -------
@@ -1037,7 +1676,57 @@ class Ria(Model):
         super().fit(X, y)
         self._model.fit(X, y, criterion._get_core(), k_best,
             _gmdh_core.PolynomialType(polynomial_type.value), test_size,
-            p_average, n_jobs, verbose, limit)
+            p_average, n_jobs, verbose, limit, executor._get_core() if executor is not None else None,
+            token._get_core() if token is not None else None)
+        return self
+
+    def fit_chunks(self, reader, criterion=Criterion(CriterionType.REGULARITY, Solver.GRAM), k_best=1,
+        polynomial_type=PolynomialType.QUADRATIC,
+        test_size=0.5, p_average=1, n_jobs=1, verbose=0, limit=0, executor=None, token=None):
+        """
+        Fitting the Ria model on the data read in chunks without loading all rows into memory.
+
+        The statistics of the internal train and test sets are accumulated chunk by chunk,
+        the first rows form the train set and the last `test_size` rows form the test set as in `fit` method.
+        The data is read once more at each level to calculate the outputs of the previous levels.
+
+        Parameters
+        ----------
+        reader : gmdh.FileChunksReader or gmdh.CallbackChunksReader
+            The source of the data rows.
+        criterion : gmdh.Criterion, default=gmdh.Criterion(gmdh.CriterionType.REGULARITY, gmdh.Solver.GRAM)
+            External criterion. It must use `gmdh.Solver.GRAM` and can't use `gmdh.CriterionType.LEAVE_ONE_OUT`.
+        k_best : int, default=1
+            The number of best combinations at each level that will be combined
+            with other unused features (or lags) at the next level.
+        polynomial_type : gmdh.PolynomialType, default=gmdh.PolynomialType.QUADRATIC
+            Specifying the type of polynomials that will be used to construct the final polynomial.
+        test_size : float, default=0.5
+            Proportion of the last rows included in the internal test set.
+        p_average : int, default=1
+            Specifying the number of the best combinations for calculation
+            the mean error value at each level.
+        n_jobs : int, default=1
+            The number of threads that will be used for calculations.
+        verbose : {0, 1}, default=0
+            If verbose=1 then the progress bars will be displayed during the model fitting.
+        limit : float, default=0
+            If the error value at the end of the level decreases by less then limit value
+            compared to the previous level the training process will stop.
+        executor : gmdh.Executor, default=None
+            The thread pool shared with the fitting of other models.
+        token : gmdh.CancellationToken, default=None
+            The token stopping the fitting after its time limit or on request.
+
+        Returns
+        -------
+        self : Ria
+            Fitted model.
+        """
+        self._model.fit_chunks(reader._get_core(), criterion._get_core(), k_best,
+            _gmdh_core.PolynomialType(polynomial_type.value), test_size,
+            p_average, n_jobs, verbose, limit, executor._get_core() if executor is not None else None,
+            token._get_core() if token is not None else None)
         return self
 
     def predict(self, X, lags=None):  # pylint: disable=invalid-name
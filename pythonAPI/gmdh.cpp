@@ -1,6 +1,8 @@
 #include <pybind11/eigen.h>
 // to convert C++ STL containers to python list
 #include <pybind11/stl.h>
+// to convert python functions to std::function
+#include <pybind11/functional.h>
 #include <exception>
 #include "../src/combi.h"
 #include "../src/multi.h"
@@ -12,6 +14,9 @@ PYBIND11_MODULE(_gmdh_core, m) {
 
     using namespace std;
     using namespace pybind11::literals;
+    // the output is redirected while holding the GIL, then it's released until the fitting is completed, 
+    // so the concurrent fittings started by Python threads share the threads of the executor
+    using FitGuard = py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect, py::gil_scoped_release>;
 
     py::register_exception<GMDH::FileException>(m, "FileError");
 
@@ -35,7 +40,9 @@ PYBIND11_MODULE(_gmdh_core, m) {
     py::enum_<GMDH::Solver>(m, "Solver")
         .value("FAST", GMDH::Solver::fast)
         .value("ACCURATE", GMDH::Solver::accurate)
-        .value("BALANCED", GMDH::Solver::balanced);
+        .value("BALANCED", GMDH::Solver::balanced)
+        .value("GRAM", GMDH::Solver::gram)
+        .value("ADAPTIVE", GMDH::Solver::adaptive);
 
     py::enum_<GMDH::CriterionType>(m, "CriterionType")
         .value("REGULARITY", GMDH::CriterionType::regularity)
@@ -46,7 +53,9 @@ PYBIND11_MODULE(_gmdh_core, m) {
         .value("SYM_UNBIASED_OUTPUTS", GMDH::CriterionType::symUnbiasedOutputs)
         .value("UNBIASED_COEFFS", GMDH::CriterionType::unbiasedCoeffs)
         .value("ABSOLUTE_NOISE_IMMUNITY", GMDH::CriterionType::absoluteNoiseImmunity)
-        .value("SYM_ABSOLUTE_NOISE_IMMUNITY", GMDH::CriterionType::symAbsoluteNoiseImmunity);
+        .value("SYM_ABSOLUTE_NOISE_IMMUNITY", GMDH::CriterionType::symAbsoluteNoiseImmunity)
+        .value("CROSS_VALIDATION", GMDH::CriterionType::crossValidation)
+        .value("LEAVE_ONE_OUT", GMDH::CriterionType::leaveOneOut);
 
     py::enum_<GMDH::PolynomialType>(m, "PolynomialType")
         .value("LINEAR", GMDH::PolynomialType::linear)
@@ -61,10 +70,53 @@ PYBIND11_MODULE(_gmdh_core, m) {
             "", "criterion_type"_a, "second_criterion_type"_a, "alpha"_a, "solver"_a);
 
     py::class_<GMDH::SequentialCriterion, GMDH::Criterion>(m, "SequentialCriterion")
-        .def(py::init<GMDH::CriterionType, GMDH::CriterionType, int, GMDH::Solver>(),
-            "", "criterion_type"_a, "second_criterion_type"_a, "top"_a, "solver"_a);
-
-    py::class_<GMDH::GmdhModel>(m, "GmdhModel");
+        .def(py::init<GMDH::CriterionType, GMDH::CriterionType, int, GMDH::Solver, int>(),
+            "", "criterion_type"_a, "second_criterion_type"_a, "top"_a, "solver"_a, "top_limit"_a);
+
+    py::class_<GMDH::FitReport>(m, "FitReport")
+        .def_readonly("evaluated_combinations", &GMDH::FitReport::evaluatedCombinations)
+        .def_readonly("pruned_combinations", &GMDH::FitReport::prunedCombinations)
+        .def_readonly("escalated_combinations", &GMDH::FitReport::escalatedCombinations)
+        .def_readonly("truncated", &GMDH::FitReport::truncated)
+        .def_readonly("screening_recall", &GMDH::FitReport::screeningRecall)
+        .def_readonly("criteria_scores", &GMDH::FitReport::criteriaScores);
+
+    py::class_<GMDH::Executor>(m, "Executor")
+        .def(py::init<int>(), "", "n_jobs"_a)
+        .def("get_threads_number", &GMDH::Executor::getThreadsNumber);
+
+    py::class_<GMDH::CancellationToken>(m, "CancellationToken")
+        .def(py::init<double>(), "", "time_limit"_a)
+        .def("cancel", &GMDH::CancellationToken::cancel)
+        .def("is_cancelled", &GMDH::CancellationToken::isCancelled);
+
+    py::class_<GMDH::ProgressInfo>(m, "ProgressInfo")
+        .def_readonly("level", &GMDH::ProgressInfo::level)
+        .def_readonly("combinations_number", &GMDH::ProgressInfo::combinationsNumber)
+        .def_readonly("done_combinations", &GMDH::ProgressInfo::doneCombinations)
+        .def_readonly("throughput", &GMDH::ProgressInfo::throughput)
+        .def_readonly("best_evaluation", &GMDH::ProgressInfo::bestEvaluation)
+        .def_readonly("level_completed", &GMDH::ProgressInfo::levelCompleted);
+
+    py::class_<GMDH::ChunksReader>(m, "ChunksReader");
+
+    py::class_<GMDH::FileChunksReader, GMDH::ChunksReader>(m, "FileChunksReader")
+        .def(py::init<const std::string&, int, int64_t>(), "", "path"_a, "cols_number"_a, "chunk_rows"_a);
+
+    py::class_<GMDH::CallbackChunksReader, GMDH::ChunksReader>(m, "CallbackChunksReader")
+        .def(py::init([](std::function<void()> rewind, std::function<std::pair<Eigen::MatrixXd, Eigen::VectorXd>()> read, 
+                         int64_t rows) {
+            return new GMDH::CallbackChunksReader(rewind, [read](Eigen::MatrixXd& x, Eigen::VectorXd& y) {
+                std::tie(x, y) = read();
+                return x.rows() > 0;
+            }, rows);
+        }), "", "rewind"_a, "read"_a, "rows"_a = -1);
+
+    py::class_<GMDH::GmdhModel>(m, "GmdhModel")
+        .def("get_fit_report", &GMDH::GmdhModel::getFitReport)
+        .def("set_progress_callback", &GMDH::GmdhModel::setProgressCallback, "", "callback"_a)
+        .def("set_screening", &GMDH::GmdhModel::setScreening, "", "rows_fraction"_a, "survivors"_a)
+        .def("set_scored_criteria", &GMDH::GmdhModel::setScoredCriteria, "", "criteria"_a);
     py::class_<GMDH::LinearModel, GMDH::GmdhModel>(m, "LinearModel");
 
     py::class_<GMDH::MULTI, GMDH::LinearModel>(m, "Multi")
@@ -75,9 +127,15 @@ PYBIND11_MODULE(_gmdh_core, m) {
             (&GMDH::GmdhModel::predict), "", "x"_a, "lags"_a)
         .def("predict", static_cast<Eigen::VectorXd(GMDH::MULTI::*) (const Eigen::MatrixXd&) const>
             (&GMDH::MULTI::predict), "" "x"_a)
-        .def("fit", &GMDH::MULTI::fit, py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect>(), 
+        .def("fit", &GMDH::MULTI::fit, FitGuard(), 
             "", "x"_a, "y"_a, "criterion"_a, "k_best"_a, "test_size"_a, 
-            "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a)
+            "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a, "executor"_a, "token"_a)
+        .def("partial_fit", &GMDH::MULTI::partialFit, FitGuard(), 
+            "", "x"_a, "y"_a, "criterion"_a, "k_best"_a, "test_size"_a, "p_average"_a, "n_jobs"_a, "verbose"_a, 
+            "limit"_a, "expired_x"_a, "expired_y"_a, "executor"_a, "token"_a)
+        .def("fit_chunks", &GMDH::MULTI::fitChunks, FitGuard(), 
+            "", "reader"_a, "criterion"_a, "k_best"_a, "test_size"_a, 
+            "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a, "executor"_a, "token"_a)
         .def("get_best_polynomial", &GMDH::MULTI::getBestPolynomial);
 
     py::class_<GMDH::COMBI, GMDH::LinearModel>(m, "Combi")
@@ -88,8 +146,15 @@ PYBIND11_MODULE(_gmdh_core, m) {
             (&GMDH::GmdhModel::predict), "", "x"_a, "lags"_a)
         .def("predict", static_cast<Eigen::VectorXd(GMDH::COMBI::*) (const Eigen::MatrixXd&) const>
             (&GMDH::COMBI::predict), "", "x"_a)
-        .def("fit", &GMDH::COMBI::fit, py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect>(),
-            "", "x"_a, "y"_a, "criterion"_a, "test_size"_a, "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a)
+        .def("fit", &GMDH::COMBI::fit, FitGuard(),
+            "", "x"_a, "y"_a, "criterion"_a, "test_size"_a, "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a,
+            "pruning"_a, "executor"_a, "token"_a)
+        .def("partial_fit", &GMDH::COMBI::partialFit, FitGuard(),
+            "", "x"_a, "y"_a, "criterion"_a, "test_size"_a, "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a,
+            "pruning"_a, "expired_x"_a, "expired_y"_a, "executor"_a, "token"_a)
+        .def("fit_chunks", &GMDH::COMBI::fitChunks, FitGuard(),
+            "", "reader"_a, "criterion"_a, "test_size"_a, "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a,
+            "pruning"_a, "executor"_a, "token"_a)
         .def("get_best_polynomial", &GMDH::COMBI::getBestPolynomial);
 
     py::class_<GMDH::MIA, GMDH::GmdhModel>(m, "Mia")
@@ -100,9 +165,12 @@ PYBIND11_MODULE(_gmdh_core, m) {
             (&GMDH::GmdhModel::predict), "", "x"_a, "lags"_a)
         .def("predict", static_cast<Eigen::VectorXd(GMDH::MIA::*) (const Eigen::MatrixXd&) const>
             (&GMDH::MIA::predict), "", "x"_a)
-        .def("fit", &GMDH::MIA::fit, py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect>(), 
+        .def("fit", &GMDH::MIA::fit, FitGuard(), 
             "", "x"_a, "y"_a, "criterion"_a, "k_best"_a, "polynomial_type"_a, "test_size"_a,
-            "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a)
+            "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a, "executor"_a, "token"_a)
+        .def("fit_chunks", &GMDH::MIA::fitChunks, FitGuard(), 
+            "", "reader"_a, "criterion"_a, "k_best"_a, "polynomial_type"_a, "test_size"_a,
+            "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a, "executor"_a, "token"_a)
         .def("get_best_polynomial", &GMDH::MIA::getBestPolynomial);
 
     py::class_<GMDH::RIA, GMDH::MIA>(m, "Ria")
@@ -113,9 +181,12 @@ PYBIND11_MODULE(_gmdh_core, m) {
             (&GMDH::GmdhModel::predict), "", "x"_a, "lags"_a)
         .def("predict", static_cast<Eigen::VectorXd(GMDH::RIA::*) (const Eigen::MatrixXd&) const>
             (&GMDH::RIA::predict), "", "x"_a)
-        .def("fit", &GMDH::RIA::fit, py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect>(),
+        .def("fit", &GMDH::RIA::fit, FitGuard(),
             "", "x"_a, "y"_a, "criterion"_a, "k_best"_a, "polynomial_type"_a, "test_size"_a,
-            "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a)
+            "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a, "executor"_a, "token"_a)
+        .def("fit_chunks", &GMDH::RIA::fitChunks, FitGuard(),
+            "", "reader"_a, "criterion"_a, "k_best"_a, "polynomial_type"_a, "test_size"_a,
+            "p_average"_a, "n_jobs"_a, "verbose"_a, "limit"_a, "executor"_a, "token"_a)
         .def("get_best_polynomial", &GMDH::RIA::getBestPolynomial);
 
     m.def("time_series_transformation", &GMDH::timeSeriesTransformation, "", "time_series"_a, "lags"_a);
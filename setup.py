@@ -25,7 +25,9 @@ class CMakeBuild(build_ext):  # pylint: disable=missing-class-docstring
         build_temp_str = str(os.path.join(Path(self.build_temp), ext.name))
         build_args = ['--config', 'Release', '--target', '_gmdh_core']
 
-        subprocess.run(["cmake", "-DCMAKE_BUILD_TYPE=Release", "-S", ".", "-B", build_temp_str],
+        # GMDH_SIMD=avx2, avx512 or native builds the module for the wider vector instructions
+        simd = os.environ.get("GMDH_SIMD", "")
+        subprocess.run(["cmake", "-DCMAKE_BUILD_TYPE=Release", f"-DGMDH_SIMD={simd}", "-S", ".", "-B", build_temp_str],
                        check=True)
         subprocess.run(["cmake", "--build", build_temp_str] + build_args, check=True)
         subprocess.run(["cp", str(os.path.join(build_temp, self.get_ext_filename(ext.name))),
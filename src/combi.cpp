@@ -6,9 +6,69 @@ VectorVu16 COMBI::generateCombinations(int n_cols) const {
 	return nChooseK(n_cols, level);
 }
 
+uint64_t COMBI::prepareCombinations(int n_cols) {
+	levelCombinations.clear();
+	levelCombinationsRange = CombinationsRange(n_cols, level);
+	return levelCombinationsRange.size();
+}
+
+void COMBI::prepareMoments(const SplittedData& data, int foldsNumber) {
+	LinearModel::prepareMoments(data, foldsNumber);
+	if (pruning && level == 1)
+		columnsOrder = rankColumns(dataMoments.all);
+}
+
+VectorU16 COMBI::rankColumns(const DataMoments& moments) const {
+	auto onesCol{ static_cast<uint16_t>(moments.xx.cols() - 1) };
+	std::vector<double> residuals(onesCol);
+	IncrementalCholesky cholesky;
+	for (uint16_t col = 0; col < onesCol; ++col)
+		residuals[col] = cholesky.residualsSquare(moments, VectorU16{ onesCol, col });
+	VectorU16 columns(onesCol);
+	std::iota(std::begin(columns), std::end(columns), 0);
+	std::stable_sort(std::begin(columns), std::end(columns), 
+		[&residuals](uint16_t a, uint16_t b) { return residuals[a] < residuals[b]; });
+	return columns;
+}
+
+void COMBI::polynomialsEvaluation(const SplittedData& data, const Criterion& criterion, ChunksScheduler& chunks, 
+	uint64_t selectionSize, VectorC& bestCombinations, TaskProgress& progress) const {
+	if (pruning)
+		prunedPolynomialsEvaluation(criterion, columnsOrder, chunks, selectionSize, 
+			bestCombinations, progress);
+	else
+		GmdhModel::polynomialsEvaluation(data, criterion, chunks, selectionSize, 
+			bestCombinations, progress);
+}
+
 GmdhModel& COMBI::fit(const MatrixXd& x, const VectorXd& y, const Criterion& criterion, double testSize,
-						int pAverage, int threads, int verbose, double limit) {
-	validateInputData(&testSize, &pAverage, &threads, &verbose, &limit);
-	return GmdhModel::gmdhFit(x, y, criterion, pAverage, testSize, pAverage, threads, verbose, limit);
+						int pAverage, int threads, int verbose, double limit, bool pruning, Executor* executor, 
+						CancellationToken* token) {
+	validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, nullptr, executor);
+	if (pruning)
+		checkPruning(criterion);
+	this->pruning = pruning;
+	return GmdhModel::gmdhFit(x, y, criterion, pAverage, testSize, pAverage, threads, verbose, limit, executor, token);
+}
+
+GmdhModel& COMBI::partialFit(const MatrixXd& x, const VectorXd& y, const Criterion& criterion, double testSize,
+							int pAverage, int threads, int verbose, double limit, bool pruning, const MatrixXd& expiredX, 
+							const VectorXd& expiredY, Executor* executor, CancellationToken* token) {
+	validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, nullptr, executor);
+	if (pruning)
+		checkPruning(criterion);
+	this->pruning = pruning;
+	return partialGmdhFit(x, y, expiredX, expiredY, criterion, pAverage, testSize, pAverage, threads, verbose, limit, 
+						  executor, token);
+}
+
+GmdhModel& COMBI::fitChunks(ChunksReader& reader, const Criterion& criterion, double testSize, int pAverage, 
+							int threads, int verbose, double limit, bool pruning, Executor* executor, 
+							CancellationToken* token) {
+	validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, nullptr, executor);
+	if (pruning)
+		checkPruning(criterion);
+	this->pruning = pruning;
+	return GmdhModel::gmdhFit(reader, criterion, pAverage, testSize, pAverage, threads, verbose, limit, executor, token);
 }
 }
\ No newline at end of file
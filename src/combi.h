@@ -5,11 +5,25 @@ namespace GMDH {
 
 /// @brief Class implementing combinatorial COMBI algorithm
 class GMDH_API COMBI : public LinearModel {
+    bool pruning; //!< True if the models of each level are searched by the branch-and-bound method, otherwise false
+    VectorU16 columnsOrder; //!< Data columns in the order of the branch-and-bound search from the best one
+
+    /**
+     * @brief Rank the data columns by the residual sum of squares of the models using only one of them
+     * 
+     * @param moments Moments of the data
+     * @return Data columns except the last column of ones in ascending order of the residual sums of squares
+     */
+    VectorU16 rankColumns(const DataMoments& moments) const;
 protected:
     VectorVu16 generateCombinations(int n_cols) const override;
+    uint64_t prepareCombinations(int n_cols) override;
+    void prepareMoments(const SplittedData& data, int foldsNumber) override;
+    void polynomialsEvaluation(const SplittedData& data, const Criterion& criterion, ChunksScheduler& chunks, 
+                               uint64_t selectionSize, VectorC& bestCombinations, TaskProgress& progress) const override;
 public:
     /// @brief Construct a new COMBI object
-    COMBI() : LinearModel() {}
+    COMBI() : LinearModel(), pruning(false) {}
 
      /**
      * @brief Fit the algorithm to find the best solution
@@ -22,6 +36,17 @@ public:
      * @param threads The number of threads used for calculations. Set -1 to use max possible threads 
      * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
      * @param limit The minimum value by which the external criterion should be improved in order to continue training
+     * @note With Solver::gram the models of each level are walked in the depth-first order of the subset tree, 
+     * so each model reuses the Cholesky decomposition of its parent extended by one column. 
+     * It is the fastest way of the exhaustive search for the data with more than 20 inputs
+     * @param pruning True if the subtrees of the models that can't be better than the already found ones should be skipped. 
+     * It requires Solver::gram and the regularity or stability criterion, whose values can't be less than the residual sum 
+     * of squares of the model using all columns of the subtree. The found models are the same as without pruning, 
+     * the number of skipped models is available in the getFitReport() result
+     * @param executor Thread pool shared with other training processes. If it is nullptr, 
+     * the pool with the given number of threads is created only for this training process
+     * @param token Token stopping the training process after the deadline or on request. If the training process 
+     * is stopped, the model is built from the already evaluated models and getFitReport() result is marked as truncated
      * @throw std::invalid_argument
      * @warning If the threads or verbose value is incorrect an exception won't be thrown. 
      * Insted, the incorrect value will be replaced with the default value and a corresponding warning will be displayed
@@ -29,6 +54,65 @@ public:
      */
     GmdhModel& fit(const MatrixXd& x, const VectorXd& y,
                     const Criterion& criterion = Criterion(CriterionType::regularity),
-                    double testSize = 0.5, int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0);
+                    double testSize = 0.5, int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0,
+                    bool pruning = false, Executor* executor = nullptr, 
+                    CancellationToken* token = nullptr);
+
+    /**
+     * @brief Fit the algorithm using the moments of all data rows appended by the previous calls and the new ones
+     * 
+     * The data rows aren't kept by the model, only the moments of its training and testing parts are updated by 
+     * the new rows and optionally by the expired ones for the sliding window, so the cost of the update depends only 
+     * on the number of these rows. The testing rows are spread evenly over the appended rows. 
+     * The moments are kept between the calls independently of fit(), so a new sequence of rows requires a new object
+     * 
+     * @param x Matrix of the new input data rows
+     * @param y Vector of the taget values for the corresponding x data
+     * @param criterion Selected external criterion. It must use Solver::gram and be calculated from the moments 
+     * of the training and testing data
+     * @param testSize Fraction of the data rows included into the testing part. It must be the same for all calls
+     * @param pAverage The number of best models based of which the external criterion for each level will be calculated
+     * @param threads The number of threads used for calculations. Set -1 to use max possible threads 
+     * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
+     * @param limit The minimum value by which the external criterion should be improved in order to continue training
+     * @param pruning True if the subtrees of the models that can't be better than the already found ones should be skipped
+     * @param expiredX Matrix of the oldest previously appended data rows that must be removed, in their original order
+     * @param expiredY Vector of the taget values for the corresponding expiredX data
+     * @param executor Thread pool shared with other training processes. If it is nullptr, 
+     * the pool with the given number of threads is created only for this training process
+     * @param token Token stopping the training process after the deadline or on request
+     * @throw std::invalid_argument
+     * @return A reference to the algorithm object for which the training was performed
+     */
+    GmdhModel& partialFit(const MatrixXd& x, const VectorXd& y,
+                          const Criterion& criterion = Criterion(CriterionType::regularity, Solver::gram),
+                          double testSize = 0.5, int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0,
+                          bool pruning = false, const MatrixXd& expiredX = MatrixXd(), 
+                          const VectorXd& expiredY = VectorXd(), Executor* executor = nullptr, 
+                          CancellationToken* token = nullptr);
+
+    /**
+     * @brief Fit the algorithm reading the data rows chunk by chunk without loading the whole data into memory
+     * 
+     * The moments of the training and testing parts are accumulated by one pass over the chunks, 
+     * so the found models are the same as after fit() with the same data and Solver::gram
+     * 
+     * @param reader Source of the data rows
+     * @param criterion Selected external criterion. It must use Solver::gram and be calculated from the moments of the data
+     * @param testSize Fraction of the last data rows that should be used to evaluate models at each level
+     * @param pAverage The number of best models based of which the external criterion for each level will be calculated
+     * @param threads The number of threads used for calculations. Set -1 to use max possible threads 
+     * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
+     * @param limit The minimum value by which the external criterion should be improved in order to continue training
+     * @param pruning True if the subtrees of the models that can't be better than the already found ones should be skipped
+     * @param executor Thread pool shared with other training processes. If it is nullptr, 
+     * the pool with the given number of threads is created only for this training process
+     * @param token Token stopping the training process after the deadline or on request
+     * @throw std::invalid_argument
+     * @return A reference to the algorithm object for which the training was performed
+     */
+    GmdhModel& fitChunks(ChunksReader& reader, const Criterion& criterion = Criterion(CriterionType::regularity, Solver::gram),
+                         double testSize = 0.5, int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0,
+                         bool pruning = false, Executor* executor = nullptr, CancellationToken* token = nullptr);
 };
 }
\ No newline at end of file
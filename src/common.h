@@ -23,10 +23,23 @@
 
 // constants
 #define MAXVERBOSENUMBER 1
+#define MINRELATIVEPIVOT 1e-10 // the minimum ratio of the Cholesky pivot to the diagonal Gram matrix element of the column
+#define BOUNDTOLERANCE 1e-9 // the relative margin of the criterion lower bound protecting the branch-and-bound search from rounding errors
+#define CHUNKDURATION 2e-3 // the time in seconds of evaluating one chunk of the level models taken by a thread
+#define CHUNKSPERTHREAD 4 // the minimum number of chunks into which each thread's share of the remaining level models is split
+#define TASKSLICEDURATION 0.05 // the time in seconds after which a task of the training process gives its thread to the waiting tasks
+#define BATCHSIZE 8 // the number of models whose small linear systems are solved together by the batched Cholesky decomposition
+#define CACHELINESIZE 64 // the size in bytes of the processor cache line
+#define PROGRESSPERIOD 0.2 // the time in seconds between the calls of the progress callback during the level
+#define SCREENINGRECALLSAMPLE 256 // the number of random level models evaluated on the sampled and all data rows to estimate the screening recall
+#define ADAPTIVEMINRATIO 1e-6 // the minimum ratio of the diagonal elements of the R factor accepted by Solver::adaptive without the pivoting decompositions
+#define CROSSVALIDATIONFOLDS 5 // the number of folds of the learning data used by the cross-validation criterion
+#define CHUNKROWS 65536 // the default number of data rows mapped into memory at once by FileChunksReader
 
 // warnings messages
 #define MINTHREADSWARNING(varName) "\nWarning: The value of '" varName "' can't be equal to 0 or a negative number other than -1. The invalid value has been replaced with the default value " varName "=1\n"
 #define MAXTHREADSWARNING(varName) "\nWarning: The value of '" varName "' can't be greater than the number of supported concurrent threads. The invalid value has been replaced wtih " varName "=-1 to use the maximum possible number of threads\n"
+#define EXECUTORTHREADSWARNING(varName) "\nWarning: The value of '" varName "' can't be greater than the number of the executor threads. The invalid value has been replaced wtih " varName "=-1 to use all threads of the executor\n"
 #define MINVERBOSEWARNING(varName) "\nWarning: The value of '" varName "' can't be negative. The invalid value has been replaced with the default value " varName "=0\n"
 #define MAXVERBOSEWARNING(varName) "\nWarning: The value of '" varName "' can't be greater than " STR(MAXVERBOSENUMBER) ". The invalid value has been replaced with " varName "=" STR(MAXVERBOSENUMBER) " to print the most detailed information\n"
 
@@ -34,6 +47,7 @@
 #define OPENFILEEXCEPTION "The file can't be opened"
 #define WRONGMODELFILEEXCEPTION(inputModel, realModel) "The expected model is " + realModel + " but the file contains " + inputModel + " model"
 #define CORRUPTEDFILEEXCEPTION "The file is corrupted"
+#define COMBINATIONSOVERFLOWEXCEPTION "The number of combinations at the level can't be stored in a 64-bit integer"
 
 namespace GMDH {
 
@@ -2,163 +2,361 @@
 
 namespace GMDH {
 
-VectorXd Criterion::findBestCoeffs(const MatrixXd& xTrain, const VectorXd& yTrain) const {
-    if ((solver == Solver::accurate))
-        return xTrain.fullPivHouseholderQr().solve(yTrain);
-    else if ((solver == Solver::balanced))
-        return xTrain.colPivHouseholderQr().solve(yTrain);
-    else
-        return xTrain.householderQr().solve(yTrain);
+template <typename MatrixType>
+void Criterion::findBestCoeffs(const MatrixXd& xTrain, const VectorXd& yTrain, QRDecompositions<MatrixType>& decompositions, 
+                               EvaluationWorkspace& workspace, VectorXd& coeffs, Solver _solver) const {
+    auto& qty{ workspace.qty };
+    qty = yTrain;
+    coeffs.setZero(xTrain.cols());
+    auto& decomposition{ workspace.decomposition };
+    decomposition = _solver == Solver::adaptive ? Solver::fast : _solver;
+    if (decomposition == Solver::fast) {
+        const auto& qr{ decompositions.householderQr.compute(xTrain) };
+        if (_solver == Solver::adaptive) { // the conditioning is estimated by the ratio of the diagonal elements of R
+            auto diagonal{ qr.matrixQR().diagonal().cwiseAbs() };
+            if (xTrain.rows() < xTrain.cols() || !(diagonal.minCoeff() > ADAPTIVEMINRATIO * diagonal.maxCoeff()))
+                decomposition = Solver::balanced;
+        }
+    }
+    if (decomposition == Solver::balanced) {
+        const auto& qr{ decompositions.colPivHouseholderQr.compute(xTrain) };
+        if (_solver == Solver::adaptive && qr.nonzeroPivots() < xTrain.cols())
+            decomposition = Solver::accurate;
+    }
+    if ((decomposition == Solver::accurate)) {
+        const auto& qr{ decompositions.fullPivHouseholderQr.compute(xTrain) };
+        auto rank{ qr.rank() };
+        double temp;
+        for (auto k = 0; k < rank; ++k) {
+            std::swap(qty[k], qty[qr.rowsTranspositions()[k]]);
+            qty.tail(qty.size() - k).applyHouseholderOnTheLeft(
+                qr.matrixQR().col(k).tail(qty.size() - k - 1), qr.hCoeffs()[k], &temp);
+        }
+        qr.matrixQR().topLeftCorner(rank, rank).template triangularView<Upper>().solveInPlace(qty.head(rank));
+        for (auto i = 0; i < rank; ++i)
+            coeffs[qr.colsPermutation().indices()[i]] = qty[i];
+    }
+    else if ((decomposition == Solver::balanced)) {
+        const auto& qr{ decompositions.colPivHouseholderQr };
+        auto rank{ qr.nonzeroPivots() };
+        qty.applyOnTheLeft(qr.householderQ().setLength(rank).adjoint());
+        qr.matrixQR().topLeftCorner(rank, rank).template triangularView<Upper>().solveInPlace(qty.head(rank));
+        for (auto i = 0; i < rank; ++i)
+            coeffs[qr.colsPermutation().indices()[i]] = qty[i];
+    }
+    else {
+        const auto& qr{ decompositions.householderQr };
+        auto rank{ std::min(xTrain.rows(), xTrain.cols()) };
+        qty.applyOnTheLeft(qr.householderQ().setLength(rank).adjoint());
+        qr.matrixQR().topLeftCorner(rank, rank).template triangularView<Upper>().solveInPlace(qty.head(rank));
+        coeffs.head(rank) = qty.head(rank);
+    }
 }
 
-PairDVXd Criterion::regularity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
-                                const VectorXd& yTest, BufferValues& bufferValues, bool inverseSplit) const {
-    if (!inverseSplit) {
-        if (bufferValues.coeffsTrain.size() == 0)
-            bufferValues.coeffsTrain = findBestCoeffs(xTrain, yTrain);
-        if (bufferValues.yPredTestByTrain.size() == 0)
-            bufferValues.yPredTestByTrain = xTest * bufferValues.coeffsTrain;
-        return PairDVXd((yTest - bufferValues.yPredTestByTrain).array().square().sum(), bufferValues.coeffsTrain);
+/**
+ * @brief Call the function with the decompositions of the workspace for the given number of columns
+ * 
+ * @tparam Function Type of the function accepting the QRDecompositions object of any matrix type
+ * @param workspace Workspace containing the decompositions
+ * @param cols The number of columns of the decomposed data
+ * @param function The called function
+ */
+template <typename Function>
+void visitDecompositions(EvaluationWorkspace& workspace, Index cols, Function&& function) {
+    auto& fixed{ workspace.fixedDecompositions };
+    switch (cols) { // the usual numbers of the model coefficients are decomposed without dynamic sizes
+    case 2: function(std::get<0>(fixed)); return;
+    case 3: function(std::get<1>(fixed)); return;
+    case 4: function(std::get<2>(fixed)); return;
+    case 5: function(std::get<3>(fixed)); return;
+    case 6: function(std::get<4>(fixed)); return;
+    case 7: function(std::get<5>(fixed)); return;
+    case 8: function(std::get<6>(fixed)); return;
     }
-    else {
-        if (bufferValues.coeffsTest.size() == 0)
-            bufferValues.coeffsTest = findBestCoeffs(xTest, yTest);
-        if (bufferValues.yPredTrainByTest.size() == 0)
-            bufferValues.yPredTrainByTest = xTrain * bufferValues.coeffsTest;
-        return PairDVXd((yTrain - bufferValues.yPredTrainByTest).array().square().sum(), bufferValues.coeffsTest);
+    function(workspace.decompositions);
+}
+
+void Criterion::findBestCoeffs(const MatrixXd& xTrain, const VectorXd& yTrain, VectorXd& coeffs, 
+                               EvaluationWorkspace& workspace) const {
+    if (solver == Solver::gram) {
+        workspace.solvedMoments.compute(xTrain, yTrain);
+        findBestCoeffs(workspace.solvedMoments, workspace.allCols(xTrain.cols()), coeffs, workspace);
+        return;
     }
+    visitDecompositions(workspace, xTrain.cols(), [&](auto& decompositions) {
+        findBestCoeffs(xTrain, yTrain, decompositions, workspace, coeffs, solver);
+    });
 }
 
-PairDVXd Criterion::symRegularity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                    const VectorXd& yTest, BufferValues& bufferValues) const {
-    PairDVXd part1 = regularity(xTrain, xTest, yTrain, yTest, bufferValues);
-    PairDVXd part2 = regularity(xTrain, xTest, yTrain, yTest, bufferValues, true);
-    return PairDVXd(part1.first + part2.first, part1.second);
-}
-
-PairDVXd Criterion::stability(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                const VectorXd& yTest, BufferValues& bufferValues, bool inverseSplit) const {
-    if (!inverseSplit) {
-        if (bufferValues.coeffsTrain.size() == 0)
-            bufferValues.coeffsTrain = findBestCoeffs(xTrain, yTrain);
-        if (bufferValues.yPredTrainByTrain.size() == 0)
-            bufferValues.yPredTrainByTrain = xTrain * bufferValues.coeffsTrain;
-        if (bufferValues.yPredTestByTrain.size() == 0)
-            bufferValues.yPredTestByTrain = xTest * bufferValues.coeffsTrain;
-        return PairDVXd((yTrain - bufferValues.yPredTrainByTrain).array().square().sum() +
-                        (yTest - bufferValues.yPredTestByTrain).array().square().sum(), bufferValues.coeffsTrain);
+void Criterion::findBestCoeffs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
+                               const VectorXd& yTest, VectorXd& coeffs, EvaluationWorkspace& workspace) const {
+    workspace.xAll.resize(xTrain.rows() + xTest.rows(), xTrain.cols());
+    workspace.xAll << xTrain, xTest;
+    workspace.yAll.resize(yTrain.size() + yTest.size());
+    workspace.yAll << yTrain, yTest;
+    findBestCoeffs(workspace.xAll, workspace.yAll, coeffs, workspace);
+}
+
+void Criterion::findBestCoeffs(const DataMoments& moments, const VectorU16& comb, VectorXd& coeffs, 
+                               EvaluationWorkspace& workspace) const {
+    switch (comb.size()) { // the usual numbers of the model coefficients are solved on the stack
+    case 2: coeffs = fixedCholeskyCoeffs<2>(moments, comb); return;
+    case 3: coeffs = fixedCholeskyCoeffs<3>(moments, comb); return;
+    case 4: coeffs = fixedCholeskyCoeffs<4>(moments, comb); return;
+    case 5: coeffs = fixedCholeskyCoeffs<5>(moments, comb); return;
+    case 6: coeffs = fixedCholeskyCoeffs<6>(moments, comb); return;
+    case 7: coeffs = fixedCholeskyCoeffs<7>(moments, comb); return;
+    case 8: coeffs = fixedCholeskyCoeffs<8>(moments, comb); return;
     }
-    else {
-        if (bufferValues.coeffsTest.size() == 0)
-            bufferValues.coeffsTest = findBestCoeffs(xTest, yTest);
-        if (bufferValues.yPredTrainByTest.size() == 0)
-            bufferValues.yPredTrainByTest = xTrain * bufferValues.coeffsTest;
-        if (bufferValues.yPredTestByTest.size() == 0)
-            bufferValues.yPredTestByTest = xTest * bufferValues.coeffsTest;
-        return PairDVXd((yTrain - bufferValues.yPredTrainByTest).array().square().sum() +
-                        (yTest - bufferValues.yPredTestByTest).array().square().sum(), bufferValues.coeffsTest);
+    workspace.cholesky.clear(); // the columns of the other moments can't be reused
+    workspace.cholesky.coeffs(moments, comb, coeffs);
+}
+
+bool Criterion::findBestCoeffs(const DataMoments* const moments[], int count, VectorXd coeffs[]) const {
+    switch (moments[0]->xx.cols()) {
+    case 2: batchedCholeskyCoeffs<2>(moments, count, coeffs); return true;
+    case 3: batchedCholeskyCoeffs<3>(moments, count, coeffs); return true;
+    case 4: batchedCholeskyCoeffs<4>(moments, count, coeffs); return true;
+    case 5: batchedCholeskyCoeffs<5>(moments, count, coeffs); return true;
+    case 6: batchedCholeskyCoeffs<6>(moments, count, coeffs); return true;
+    case 7: batchedCholeskyCoeffs<7>(moments, count, coeffs); return true;
+    case 8: batchedCholeskyCoeffs<8>(moments, count, coeffs); return true;
     }
+    return false;
 }
 
-PairDVXd Criterion::symStability(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                    const VectorXd& yTest, BufferValues& bufferValues) const {
-    PairDVXd part1 = stability(xTrain, xTest, yTrain, yTest, bufferValues);
-    PairDVXd part2 = stability(xTrain, xTest, yTrain, yTest, bufferValues, true);
-    return PairDVXd(part1.first + part2.first, part1.second);
+bool Criterion::residualsSquares(const DataMoments* const moments[], int count, const VectorXd coeffs[], double rss[]) const {
+    switch (moments[0]->xx.cols()) {
+    case 2: batchedResidualsSquares<2>(moments, count, coeffs, rss); return true;
+    case 3: batchedResidualsSquares<3>(moments, count, coeffs, rss); return true;
+    case 4: batchedResidualsSquares<4>(moments, count, coeffs, rss); return true;
+    case 5: batchedResidualsSquares<5>(moments, count, coeffs, rss); return true;
+    case 6: batchedResidualsSquares<6>(moments, count, coeffs, rss); return true;
+    case 7: batchedResidualsSquares<7>(moments, count, coeffs, rss); return true;
+    case 8: batchedResidualsSquares<8>(moments, count, coeffs, rss); return true;
+    }
+    return false;
 }
 
-PairDVXd Criterion::unbiasedOutputs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                    const VectorXd& yTest, BufferValues& bufferValues) const {
-    if (bufferValues.coeffsTrain.size() == 0)
-        bufferValues.coeffsTrain = findBestCoeffs(xTrain, yTrain);
-    if (bufferValues.coeffsTest.size() == 0)
-        bufferValues.coeffsTest = findBestCoeffs(xTest, yTest);
-    if (bufferValues.yPredTestByTrain.size() == 0)
-        bufferValues.yPredTestByTrain = xTest * bufferValues.coeffsTrain;
-    if (bufferValues.yPredTestByTest.size() == 0)
-        bufferValues.yPredTestByTest = xTest * bufferValues.coeffsTest;
-    return PairDVXd((bufferValues.yPredTestByTrain - bufferValues.yPredTestByTest).array().square().sum(), 
-                        bufferValues.coeffsTrain);
-}
-
-PairDVXd Criterion::symUnbiasedOutputs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                        const VectorXd& yTest, BufferValues& bufferValues) const {
-    if (bufferValues.coeffsTrain.size() == 0)
-        bufferValues.coeffsTrain = findBestCoeffs(xTrain, yTrain);
-    if (bufferValues.coeffsTest.size() == 0)
-        bufferValues.coeffsTest = findBestCoeffs(xTest, yTest);
-    if (bufferValues.yPredTrainByTrain.size() == 0)
-        bufferValues.yPredTrainByTrain = xTrain * bufferValues.coeffsTrain;
-    if (bufferValues.yPredTrainByTest.size() == 0)
-        bufferValues.yPredTrainByTest = xTrain * bufferValues.coeffsTest;
-    if (bufferValues.yPredTestByTrain.size() == 0)
-        bufferValues.yPredTestByTrain = xTest * bufferValues.coeffsTrain;
-    if (bufferValues.yPredTestByTest.size() == 0)
-        bufferValues.yPredTestByTest = xTest * bufferValues.coeffsTest;
-    return PairDVXd((bufferValues.yPredTrainByTrain - bufferValues.yPredTrainByTest).array().square().sum() +
-                    (bufferValues.yPredTestByTrain - bufferValues.yPredTestByTest).array().square().sum(), 
-                        bufferValues.coeffsTrain);
-}
-
-PairDVXd Criterion::unbiasedCoeffs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                    const VectorXd& yTest, BufferValues& bufferValues) const {
-    if (bufferValues.coeffsTrain.size() == 0)
-        bufferValues.coeffsTrain = findBestCoeffs(xTrain, yTrain);
-    if (bufferValues.coeffsTest.size() == 0)
-        bufferValues.coeffsTest = findBestCoeffs(xTest, yTest);
-    return PairDVXd((bufferValues.coeffsTrain - bufferValues.coeffsTest).array().square().sum(), 
-                        bufferValues.coeffsTrain);
+void Criterion::checkEscalation(BufferValues& bufferValues) const {
+    if (solver == Solver::adaptive && bufferValues.workspace.decomposition != Solver::fast)
+        bufferValues.isEscalated = true;
 }
 
-PairDVXd Criterion::absoluteNoiseImmunity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                        const VectorXd& yTest, BufferValues& bufferValues) const {
-    VectorXd yPredTestByAll;
-    if (bufferValues.coeffsTrain.size() == 0)
-        bufferValues.coeffsTrain = findBestCoeffs(xTrain, yTrain);
-    if (bufferValues.coeffsTest.size() == 0)
-        bufferValues.coeffsTest = findBestCoeffs(xTest, yTest);
-    if (bufferValues.coeffsAll.size() == 0) {
-        MatrixXd dataX(xTrain.rows() + xTest.rows(), xTrain.cols());
-        dataX << xTrain, xTest;
-        VectorXd dataY(yTrain.size() + yTest.size());
-        dataY << yTrain, yTest;
-        bufferValues.coeffsAll = findBestCoeffs(dataX, dataY);
+const VectorXd& Criterion::coeffsTrain(const MatrixXd& xTrain, const VectorXd& yTrain, BufferValues& bufferValues) const {
+    if (!bufferValues.isTrainSolved) {
+        findBestCoeffs(xTrain, yTrain, bufferValues.coeffsTrain, bufferValues.workspace);
+        bufferValues.isTrainSolved = true;
+        checkEscalation(bufferValues);
     }
-    if (bufferValues.yPredTestByTrain.size() == 0)
-        bufferValues.yPredTestByTrain = xTest * bufferValues.coeffsTrain;
-    if (bufferValues.yPredTestByTest.size() == 0)
-        bufferValues.yPredTestByTest = xTest * bufferValues.coeffsTest;
-    yPredTestByAll = xTest * bufferValues.coeffsAll;
+    return bufferValues.coeffsTrain;
+}
 
-    return PairDVXd((yPredTestByAll - bufferValues.yPredTestByTrain).dot(
-        bufferValues.yPredTestByTest - yPredTestByAll), bufferValues.coeffsTrain);
+const VectorXd& Criterion::coeffsTest(const MatrixXd& xTest, const VectorXd& yTest, BufferValues& bufferValues) const {
+    if (!bufferValues.isTestSolved) {
+        findBestCoeffs(xTest, yTest, bufferValues.coeffsTest, bufferValues.workspace);
+        bufferValues.isTestSolved = true;
+        checkEscalation(bufferValues);
+    }
+    return bufferValues.coeffsTest;
 }
 
-PairDVXd Criterion::symAbsoluteNoiseImmunity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                            const VectorXd& yTest, BufferValues& bufferValues) const {
-    VectorXd yPredAllByTrain, yPredAllByTest, yPredAllByAll;
-    MatrixXd dataX(xTrain.rows() + xTest.rows(), xTrain.cols());
-    dataX << xTrain, xTest;
-    VectorXd dataY(yTrain.size() + yTest.size());
-    dataY << yTrain, yTest;
+const VectorXd& Criterion::coeffsAll(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
+                                     const VectorXd& yTest, BufferValues& bufferValues) const {
+    if (!bufferValues.isAllSolved) {
+        findBestCoeffs(xTrain, xTest, yTrain, yTest, bufferValues.coeffsAll, bufferValues.workspace);
+        bufferValues.isAllSolved = true;
+        checkEscalation(bufferValues);
+    }
+    return bufferValues.coeffsAll;
+}
 
-    if (bufferValues.coeffsTrain.size() == 0)
-        bufferValues.coeffsTrain = findBestCoeffs(xTrain, yTrain);
-    if (bufferValues.coeffsTest.size() == 0)
-        bufferValues.coeffsTest = findBestCoeffs(xTest, yTest);
-    if (bufferValues.coeffsAll.size() == 0)
-        bufferValues.coeffsAll = findBestCoeffs(dataX, dataY);
+double Criterion::regularity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
+                             const VectorXd& yTest, BufferValues& bufferValues, bool inverseSplit) const {
+    if (!inverseSplit)
+        return (yTest - xTest.lazyProduct(coeffsTrain(xTrain, yTrain, bufferValues))).squaredNorm();
+    else
+        return (yTrain - xTrain.lazyProduct(coeffsTest(xTest, yTest, bufferValues))).squaredNorm();
+}
 
-    yPredAllByTrain = dataX * bufferValues.coeffsTrain;
-    yPredAllByTest = dataX * bufferValues.coeffsTest;
-    yPredAllByAll = dataX * bufferValues.coeffsAll;
+double Criterion::symRegularity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                                const VectorXd& yTest, BufferValues& bufferValues) const {
+    return regularity(xTrain, xTest, yTrain, yTest, bufferValues) + 
+           regularity(xTrain, xTest, yTrain, yTest, bufferValues, true);
+}
+
+double Criterion::stability(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                            const VectorXd& yTest, BufferValues& bufferValues, bool inverseSplit) const {
+    const auto& coeffs{ !inverseSplit ? coeffsTrain(xTrain, yTrain, bufferValues) : coeffsTest(xTest, yTest, bufferValues) };
+    return (yTrain - xTrain.lazyProduct(coeffs)).squaredNorm() + (yTest - xTest.lazyProduct(coeffs)).squaredNorm();
+}
+
+double Criterion::symStability(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                               const VectorXd& yTest, BufferValues& bufferValues) const {
+    const auto& coeffsTrain{ this->coeffsTrain(xTrain, yTrain, bufferValues) };
+    const auto& coeffsTest{ this->coeffsTest(xTest, yTest, bufferValues) };
+    auto residualsSquare = [&](const MatrixXd& x, const VectorXd& y) { // both models are checked in one pass over the data
+        return ((y - x.lazyProduct(coeffsTrain)).array().square() + (y - x.lazyProduct(coeffsTest)).array().square()).sum();
+    };
+    return residualsSquare(xTrain, yTrain) + residualsSquare(xTest, yTest);
+}
+
+double Criterion::unbiasedOutputs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                                  const VectorXd& yTest, BufferValues& bufferValues) const {
+    const auto& coeffsTrain{ this->coeffsTrain(xTrain, yTrain, bufferValues) };
+    const auto& coeffsTest{ this->coeffsTest(xTest, yTest, bufferValues) };
+    return (xTest.lazyProduct(coeffsTrain) - xTest.lazyProduct(coeffsTest)).squaredNorm();
+}
+
+double Criterion::symUnbiasedOutputs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                                     const VectorXd& yTest, BufferValues& bufferValues) const {
+    const auto& coeffsTrain{ this->coeffsTrain(xTrain, yTrain, bufferValues) };
+    const auto& coeffsTest{ this->coeffsTest(xTest, yTest, bufferValues) };
+    return (xTrain.lazyProduct(coeffsTrain) - xTrain.lazyProduct(coeffsTest)).squaredNorm() +
+           (xTest.lazyProduct(coeffsTrain) - xTest.lazyProduct(coeffsTest)).squaredNorm();
+}
 
-    return PairDVXd((yPredAllByAll - yPredAllByTrain).dot(yPredAllByTest - yPredAllByAll), 
-        bufferValues.coeffsTrain);
+double Criterion::unbiasedCoeffs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                                 const VectorXd& yTest, BufferValues& bufferValues) const {
+    const auto& coeffsTrain{ this->coeffsTrain(xTrain, yTrain, bufferValues) };
+    const auto& coeffsTest{ this->coeffsTest(xTest, yTest, bufferValues) };
+    return (coeffsTrain - coeffsTest).array().square().sum();
 }
 
-PairDVXd Criterion::getResult(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
-                                const VectorXd& yTest, CriterionType _criterionType, BufferValues& bufferValues) const {
+double Criterion::absoluteNoiseImmunity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                                        const VectorXd& yTest, BufferValues& bufferValues) const {
+    const auto& coeffsTrain{ this->coeffsTrain(xTrain, yTrain, bufferValues) };
+    const auto& coeffsTest{ this->coeffsTest(xTest, yTest, bufferValues) };
+    const auto& coeffsAll{ this->coeffsAll(xTrain, xTest, yTrain, yTest, bufferValues) };
+    return (xTest.lazyProduct(coeffsAll) - xTest.lazyProduct(coeffsTrain)).dot(
+        xTest.lazyProduct(coeffsTest) - xTest.lazyProduct(coeffsAll));
+}
+
+double Criterion::symAbsoluteNoiseImmunity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                                           const VectorXd& yTest, BufferValues& bufferValues) const {
+    const auto& coeffsTrain{ this->coeffsTrain(xTrain, yTrain, bufferValues) };
+    const auto& coeffsTest{ this->coeffsTest(xTest, yTest, bufferValues) };
+    const auto& coeffsAll{ this->coeffsAll(xTrain, xTest, yTrain, yTest, bufferValues) };
+    auto predictionsProduct = [&](const MatrixXd& x) { // the learning data is processed as its two parts
+        return (x.lazyProduct(coeffsAll) - x.lazyProduct(coeffsTrain)).dot(x.lazyProduct(coeffsTest) - x.lazyProduct(coeffsAll));
+    };
+    return predictionsProduct(xTrain) + predictionsProduct(xTest);
+}
+
+double Criterion::crossValidation(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                                  const VectorXd& yTest, BufferValues& bufferValues) const {
+    coeffsTrain(xTrain, yTrain, bufferValues); // the coefficients of the model are trained on all training data
+    auto& workspace{ bufferValues.workspace };
+    workspace.moments.compute(xTrain, xTest, yTrain, yTest, CROSSVALIDATIONFOLDS);
+    return crossValidation(workspace.moments, workspace.allCols(xTrain.cols()), workspace);
+}
+
+double Criterion::crossValidation(const SplittedMoments& moments, const VectorU16& comb, EvaluationWorkspace& workspace) const {
+    const auto& cols{ workspace.allCols(comb.size()) }; // the moments of the remaining rows contain only the model columns
+    double result{ 0 };
+    for (const auto& fold : moments.folds) {
+        if (fold.rows > 0) {
+            moments.all.difference(fold, comb, workspace.solvedMoments);
+            findBestCoeffs(workspace.solvedMoments, cols, workspace.foldCoeffs, workspace);
+            result += fold.residualsSquare(comb, workspace.foldCoeffs);
+        }
+    }
+    return result;
+}
+
+
+/**
+ * @brief Calculate the diagonal elements of the hat matrix of the data using its QR decomposition
+ * 
+ * @tparam Factor Type of the upper triangular factor block
+ * @tparam Indexes Type of the vector of the column indexes
+ * @param x Input matrix of the decomposed data
+ * @param r Upper triangular factor of the linearly independent columns
+ * @param cols Indexes of the input matrix columns in the order of the factor columns
+ * @param z Matrix to which \f$ X_{cols}R^{-1} \f$ will be written
+ * @param leverages Vector to which the squared norms of the rows of z will be written
+ */
+template <typename Factor, typename Indexes>
+void hatDiagonal(const MatrixXd& x, const Factor& r, const Indexes& cols, MatrixXd& z, VectorXd& leverages) {
+    z.resize(x.rows(), r.cols());
+    for (Index i = 0; i < r.cols(); ++i)
+        z.col(i) = x.col(cols[i]);
+    r.template triangularView<Upper>().template solveInPlace<OnTheRight>(z);
+    leverages = z.rowwise().squaredNorm();
+}
+
+double Criterion::leaveOneOut(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                              const VectorXd& yTest, BufferValues& bufferValues) const {
+    coeffsTrain(xTrain, yTrain, bufferValues); // the model keeps the coefficients of the training data
+    auto& workspace{ bufferValues.workspace };
+    auto& leverages{ workspace.leverages };
+    // the coefficients solved before by other decompositions are solved again, because the leverages need the decomposition
+    auto& coeffs{ bufferValues.isAllSolved ? workspace.foldCoeffs : bufferValues.coeffsAll };
+    if (solver == Solver::gram) { // the learning data isn't constructed, its moments are the sum of the moments of both parts
+        auto& cholesky{ workspace.cholesky };
+        workspace.solvedMoments.compute(xTrain, yTrain);
+        workspace.solvedMoments.add(xTest, yTest);
+        cholesky.clear();
+        for (auto col = 0; col < xTrain.cols(); ++col)
+            cholesky.append(workspace.solvedMoments, col);
+        cholesky.coeffs(coeffs);
+        bufferValues.isAllSolved = true;
+        auto result{ predictedResidualsSquare(xTrain, yTrain, coeffs, cholesky.leverages(xTrain)) };
+        if (result == std::numeric_limits<double>::max())
+            return result;
+        auto testResult{ predictedResidualsSquare(xTest, yTest, coeffs, cholesky.leverages(xTest)) };
+        return testResult == std::numeric_limits<double>::max() ? testResult : result + testResult;
+    }
+    auto& xAll{ workspace.xAll };
+    auto& yAll{ workspace.yAll };
+    xAll.resize(xTrain.rows() + xTest.rows(), xTrain.cols());
+    xAll << xTrain, xTest;
+    yAll.resize(yTrain.size() + yTest.size());
+    yAll << yTrain, yTest;
+    visitDecompositions(workspace, xAll.cols(), [&](auto& decompositions) {
+        findBestCoeffs(xAll, yAll, decompositions, workspace, coeffs, solver);
+        if (workspace.decomposition == Solver::fast) {
+            const auto& qr{ decompositions.householderQr };
+            auto diagonal{ qr.matrixQR().diagonal().cwiseAbs() };
+            auto cols{ xAll.cols() };
+            if (xAll.rows() >= cols && diagonal.minCoeff() > MINRELATIVEPIVOT * diagonal.maxCoeff()) {
+                hatDiagonal(xAll, qr.matrixQR().topLeftCorner(cols, cols), workspace.allCols(cols), 
+                            workspace.hatFactor, leverages);
+                return;
+            } // the near-zero diagonal elements of the unpivoted factor mean the rank loss, so the columns are pivoted
+            findBestCoeffs(xAll, yAll, decompositions, workspace, coeffs, Solver::balanced);
+        }
+        if (workspace.decomposition == Solver::accurate) {
+            const auto& qr{ decompositions.fullPivHouseholderQr };
+            hatDiagonal(xAll, qr.matrixQR().topLeftCorner(qr.rank(), qr.rank()), qr.colsPermutation().indices(), 
+                        workspace.hatFactor, leverages);
+        }
+        else {
+            const auto& qr{ decompositions.colPivHouseholderQr };
+            auto rank{ qr.nonzeroPivots() };
+            hatDiagonal(xAll, qr.matrixQR().topLeftCorner(rank, rank), qr.colsPermutation().indices(), 
+                        workspace.hatFactor, leverages);
+        }
+    });
+    bufferValues.isAllSolved = true;
+    checkEscalation(bufferValues); // the model escalated by both decompositions is counted once
+    return predictedResidualsSquare(xAll, yAll, coeffs, leverages);
+}
+
+double Criterion::predictedResidualsSquare(const MatrixXd& x, const VectorXd& y, const VectorXd& coeffs, 
+                                           const VectorXd& leverages) {
+    if (!((1 - leverages.array()) > MINRELATIVEPIVOT).all()) // the row is the only one determining some of the coefficients
+        return std::numeric_limits<double>::max();
+    return ((y - x.lazyProduct(coeffs)).array() / (1 - leverages.array())).square().sum();
+}
+
+double Criterion::getResult(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
+                            const VectorXd& yTest, CriterionType _criterionType, BufferValues& bufferValues) const {
+    if (solver == Solver::gram && !usesDataRows(_criterionType)) {
+        auto& workspace{ bufferValues.workspace };
+        workspace.moments.compute(xTrain, xTest, yTrain, yTest, usedFolds(_criterionType));
+        return getResult(workspace.moments, workspace.allCols(xTrain.cols()), _criterionType, bufferValues);
+    }
     switch (_criterionType) {
     case CriterionType::regularity:
         return regularity(xTrain, xTest, yTrain, yTest, bufferValues);
@@ -178,18 +376,172 @@ PairDVXd Criterion::getResult(const MatrixXd& xTrain, const MatrixXd& xTest, con
         return absoluteNoiseImmunity(xTrain, xTest, yTrain, yTest, bufferValues);
     case CriterionType::symAbsoluteNoiseImmunity:
         return symAbsoluteNoiseImmunity(xTrain, xTest, yTrain, yTest, bufferValues); 
+    case CriterionType::crossValidation:
+        return crossValidation(xTrain, xTest, yTrain, yTest, bufferValues);
+    case CriterionType::leaveOneOut:
+        return leaveOneOut(xTrain, xTest, yTrain, yTest, bufferValues);
+    } // LCOV_EXCL_LINE
+    throw std::invalid_argument("Unknown criterion type"); // LCOV_EXCL_LINE
+}
+
+double Criterion::getResult(const SplittedMoments& moments, const VectorU16& comb, 
+                            CriterionType _criterionType, BufferValues& bufferValues) const {
+    auto& workspace{ bufferValues.workspace };
+    auto solve = [&](const DataMoments& data, VectorXd& coeffs, bool& isSolved) -> const VectorXd& {
+        if (!isSolved) {
+            findBestCoeffs(data, comb, coeffs, workspace);
+            isSolved = true;
+        }
+        return coeffs;
+    };
+    const auto& coeffsTrain{ solve(moments.train, bufferValues.coeffsTrain, bufferValues.isTrainSolved) };
+    auto coeffsTest = [&]() -> const VectorXd& {
+        return solve(moments.test, bufferValues.coeffsTest, bufferValues.isTestSolved);
+    };
+    auto coeffsAll = [&]() -> const VectorXd& {
+        return solve(moments.all, bufferValues.coeffsAll, bufferValues.isAllSolved);
+    };
+    auto& diff{ workspace.difference };
+    auto& secondDiff{ workspace.secondDifference };
+
+    switch (_criterionType) {
+    case CriterionType::regularity:
+        return moments.test.residualsSquare(comb, coeffsTrain);
+    case CriterionType::symRegularity:
+        return moments.test.residualsSquare(comb, coeffsTrain) + moments.train.residualsSquare(comb, coeffsTest());
+    case CriterionType::stability:
+        return moments.all.residualsSquare(comb, coeffsTrain);
+    case CriterionType::symStability:
+        return moments.all.residualsSquare(comb, coeffsTrain) + moments.all.residualsSquare(comb, coeffsTest());
+    case CriterionType::unbiasedOutputs:
+        diff = coeffsTrain - coeffsTest();
+        return std::max(0.0, moments.test.dot(comb, diff, diff));
+    case CriterionType::symUnbiasedOutputs:
+        diff = coeffsTrain - coeffsTest();
+        return std::max(0.0, moments.all.dot(comb, diff, diff));
+    case CriterionType::unbiasedCoeffs:
+        return (coeffsTrain - coeffsTest()).squaredNorm();
+    case CriterionType::absoluteNoiseImmunity:
+        diff = coeffsAll() - coeffsTrain;
+        secondDiff = coeffsTest() - coeffsAll();
+        return moments.test.dot(comb, diff, secondDiff);
+    case CriterionType::symAbsoluteNoiseImmunity:
+        diff = coeffsAll() - coeffsTrain;
+        secondDiff = coeffsTest() - coeffsAll();
+        return moments.all.dot(comb, diff, secondDiff);
+    case CriterionType::crossValidation:
+        return crossValidation(moments, comb, workspace);
+    case CriterionType::leaveOneOut:
+        throw std::invalid_argument("The leave-one-out criterion can't be calculated using the data moments");
     } // LCOV_EXCL_LINE
-} // LCOV_EXCL_LINE
+    throw std::invalid_argument("Unknown criterion type"); // LCOV_EXCL_LINE
+}
+
+bool Criterion::getResults(const SplittedMoments* const moments[], int count, const VectorXd coeffsTrain[], 
+                           const VectorXd coeffsTest[], CriterionType _criterionType, double results[]) const {
+    const DataMoments* train[BATCHSIZE], * test[BATCHSIZE], * all[BATCHSIZE];
+    for (auto i = 0; i < count; ++i) {
+        train[i] = &moments[i]->train;
+        test[i] = &moments[i]->test;
+        all[i] = &moments[i]->all;
+    }
+    double secondResults[BATCHSIZE];
+    switch (_criterionType) {
+    case CriterionType::regularity:
+        return residualsSquares(test, count, coeffsTrain, results);
+    case CriterionType::symRegularity:
+        if (!residualsSquares(test, count, coeffsTrain, results) || !residualsSquares(train, count, coeffsTest, secondResults))
+            return false;
+        break;
+    case CriterionType::stability:
+        return residualsSquares(all, count, coeffsTrain, results);
+    case CriterionType::symStability:
+        if (!residualsSquares(all, count, coeffsTrain, results) || !residualsSquares(all, count, coeffsTest, secondResults))
+            return false;
+        break;
+    default: // the other criteria aren't the residual sums of squares
+        return false;
+    }
+    for (auto i = 0; i < count; ++i)
+        results[i] += secondResults[i];
+    return true;
+}
 
 Criterion::Criterion(CriterionType _criterionType, Solver _solver) {
     criterionType = _criterionType;
     solver = _solver;
 }
 
-PairDVXd Criterion::calculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                const VectorXd& yTest) const {
-    BufferValues tempValues;
-    return getResult(xTrain, xTest, yTrain, yTest, criterionType, tempValues);
+double Criterion::calculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                            const VectorXd& yTest, BufferValues& bufferValues) const {
+    return getResult(xTrain, xTest, yTrain, yTest, criterionType, bufferValues);
+}
+
+double Criterion::calculate(const SplittedMoments& moments, const VectorU16& comb, BufferValues& bufferValues) const {
+    return getResult(moments, comb, criterionType, bufferValues);
+}
+
+bool Criterion::calculate(const SplittedMoments* const moments[], int count, const VectorXd coeffsTrain[], 
+                          const VectorXd coeffsTest[], double evaluations[]) const {
+    return getResults(moments, count, coeffsTrain, coeffsTest, criterionType, evaluations);
+}
+
+void Criterion::usedCoeffs(bool& coeffsTest, bool& coeffsAll) const {
+    coeffsTest = coeffsAll = false;
+    usedCoeffs(criterionType, coeffsTest, coeffsAll);
+}
+
+void Criterion::usedCoeffs(CriterionType _criterionType, bool& coeffsTest, bool& coeffsAll) {
+    coeffsTest = coeffsTest || (_criterionType != CriterionType::regularity && _criterionType != CriterionType::stability && 
+                                _criterionType != CriterionType::crossValidation && _criterionType != CriterionType::leaveOneOut);
+    coeffsAll = coeffsAll || _criterionType == CriterionType::absoluteNoiseImmunity || 
+                _criterionType == CriterionType::symAbsoluteNoiseImmunity;
+}
+
+int Criterion::usedFolds() const {
+    return usedFolds(criterionType);
+}
+
+int Criterion::usedFolds(CriterionType _criterionType) {
+    return _criterionType == CriterionType::crossValidation ? CROSSVALIDATIONFOLDS : 0;
+}
+
+bool Criterion::usesDataRows() const {
+    return usesDataRows(criterionType);
+}
+
+bool Criterion::usesDataRows(CriterionType _criterionType) {
+    return _criterionType == CriterionType::leaveOneOut;
+}
+
+double Criterion::getLowerBound(double rssTrain, double rssTest, double rssAll) const {
+    return getLowerBound(criterionType, rssTrain, rssTest, rssAll);
+}
+
+double Criterion::getLowerBound(CriterionType _criterionType, double rssTrain, double rssTest, double rssAll) {
+    switch (_criterionType) {
+    case CriterionType::regularity:
+        return rssTest; // the coefficients of the training data are one of the solutions on the testing data
+    case CriterionType::symRegularity:
+        return rssTest + rssTrain;
+    case CriterionType::stability:
+        return rssAll;
+    case CriterionType::symStability:
+        return 2 * rssAll;
+    default:
+        return std::numeric_limits<double>::lowest();
+    }
+}
+
+void Criterion::usedResiduals(bool& rssTrain, bool& rssTest, bool& rssAll) const {
+    rssTrain = rssTest = rssAll = false;
+    usedResiduals(criterionType, rssTrain, rssTest, rssAll);
+}
+
+void Criterion::usedResiduals(CriterionType _criterionType, bool& rssTrain, bool& rssTest, bool& rssAll) {
+    rssTrain = rssTrain || _criterionType == CriterionType::symRegularity;
+    rssTest = rssTest || _criterionType == CriterionType::regularity || _criterionType == CriterionType::symRegularity;
+    rssAll = rssAll || _criterionType == CriterionType::stability || _criterionType == CriterionType::symStability;
 }
 
 ParallelCriterion::ParallelCriterion(CriterionType _firstCriterionType, CriterionType _secondCriterionType,
@@ -201,58 +553,129 @@ ParallelCriterion::ParallelCriterion(CriterionType _firstCriterionType, Criterio
     secondCriterionType = _secondCriterionType;
 }
 
-PairDVXd ParallelCriterion::calculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                        const VectorXd& yTest) const {
-    BufferValues tempValues;
-    PairDVXd firstResult = Criterion::getResult(xTrain, xTest, yTrain, yTest, criterionType, tempValues);
-    PairDVXd secondResult = Criterion::getResult(xTrain, xTest, yTrain, yTest, secondCriterionType, tempValues);
-    return PairDVXd(alpha * firstResult.first + (1 - alpha) * secondResult.first, firstResult.second);
+double ParallelCriterion::calculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                                    const VectorXd& yTest, BufferValues& bufferValues) const {
+    auto firstResult{ Criterion::getResult(xTrain, xTest, yTrain, yTest, criterionType, bufferValues) };
+    auto secondResult{ Criterion::getResult(xTrain, xTest, yTrain, yTest, secondCriterionType, bufferValues) };
+    return alpha * firstResult + (1 - alpha) * secondResult;
 }
 
-VectorC SequentialCriterion::getBestCombinations(VectorC& combinations, const SplittedData& data, 
-    const std::function<MatrixXd(const MatrixXd&, const VectorU16&)> func, int k) const {
+double ParallelCriterion::calculate(const SplittedMoments& moments, const VectorU16& comb, 
+                                    BufferValues& bufferValues) const {
+    auto firstResult{ Criterion::getResult(moments, comb, criterionType, bufferValues) };
+    auto secondResult{ Criterion::getResult(moments, comb, secondCriterionType, bufferValues) };
+    return alpha * firstResult + (1 - alpha) * secondResult;
+}
 
-    int real_top = ((top >= k) ? top : (combinations.size() - k) * 0.5 + k);
-    auto bestCombinations = Criterion::getBestCombinations(combinations, data, func, real_top);
-    for (auto& combBegin : bestCombinations) {
-        auto pairCoeffsEvaluation = recalculate(func(data.xTrain, combBegin.combination()),
-                                                func(data.xTest, combBegin.combination()),
-                                                data.yTrain, data.yTest, combBegin.bestCoeffs());
-        combBegin.setEvaluation(pairCoeffsEvaluation.first);
-    }
-    return Criterion::getBestCombinations(bestCombinations, data, func, k);
+bool ParallelCriterion::calculate(const SplittedMoments* const moments[], int count, const VectorXd coeffsTrain[], 
+                                  const VectorXd coeffsTest[], double evaluations[]) const {
+    double secondResults[BATCHSIZE];
+    if (!Criterion::getResults(moments, count, coeffsTrain, coeffsTest, criterionType, evaluations) ||
+        !Criterion::getResults(moments, count, coeffsTrain, coeffsTest, secondCriterionType, secondResults))
+        return false;
+    for (auto i = 0; i < count; ++i)
+        evaluations[i] = alpha * evaluations[i] + (1 - alpha) * secondResults[i];
+    return true;
+}
+
+void ParallelCriterion::usedCoeffs(bool& coeffsTest, bool& coeffsAll) const {
+    Criterion::usedCoeffs(coeffsTest, coeffsAll);
+    Criterion::usedCoeffs(secondCriterionType, coeffsTest, coeffsAll);
+}
+
+int ParallelCriterion::usedFolds() const {
+    return std::max(Criterion::usedFolds(), Criterion::usedFolds(secondCriterionType));
+}
+
+bool ParallelCriterion::usesDataRows() const {
+    return Criterion::usesDataRows() || Criterion::usesDataRows(secondCriterionType);
+}
+
+double ParallelCriterion::getLowerBound(double rssTrain, double rssTest, double rssAll) const {
+    auto firstBound{ Criterion::getLowerBound(criterionType, rssTrain, rssTest, rssAll) };
+    auto secondBound{ Criterion::getLowerBound(secondCriterionType, rssTrain, rssTest, rssAll) };
+    if (firstBound == std::numeric_limits<double>::lowest() || secondBound == std::numeric_limits<double>::lowest())
+        return std::numeric_limits<double>::lowest();
+    return alpha * firstBound + (1 - alpha) * secondBound;
+}
+
+void ParallelCriterion::usedResiduals(bool& rssTrain, bool& rssTest, bool& rssAll) const {
+    Criterion::usedResiduals(rssTrain, rssTest, rssAll);
+    Criterion::usedResiduals(secondCriterionType, rssTrain, rssTest, rssAll);
+}
+
+uint64_t SequentialCriterion::getSelectionSize(uint64_t combinationsNumber, int k) const {
+    if (top >= k)
+        return std::min(static_cast<uint64_t>(top), combinationsNumber);
+    if (combinationsNumber <= static_cast<uint64_t>(k))
+        return combinationsNumber;
+    auto selectionSize{ static_cast<uint64_t>((combinationsNumber - k) * 0.5 + k) };
+    if (topLimit == 0)
+        return selectionSize;
+    // the selected models are kept in memory until the end of the level, so the limit bounds the memory of the large levels
+    return std::min(selectionSize, static_cast<uint64_t>(std::max(topLimit, k)));
 }
 
 SequentialCriterion::SequentialCriterion(CriterionType _firstCriterionType, 
                                          CriterionType _secondCriterionType,
-                                         int _top, Solver _solver) : Criterion(_firstCriterionType, _solver) {
+                                         int _top, Solver _solver, int _topLimit) : Criterion(_firstCriterionType, _solver) {
     secondCriterionType = _secondCriterionType;
     if (_top < 0) {
         std::string errorMsg = getVariableName("_top", "top") + " value must be a non-negative integer";
         throw std::invalid_argument(errorMsg);
     }
+    if (_topLimit < 0) {
+        std::string errorMsg = getVariableName("_topLimit", "top_limit") + " value must be a non-negative integer";
+        throw std::invalid_argument(errorMsg);
+    }
     top = _top;
+    topLimit = _topLimit;
 }
 
-PairDVXd SequentialCriterion::recalculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
-                                            const VectorXd& yTest, const VectorXd& _coeffsTrain) const {
-    BufferValues tempValues;
-    tempValues.coeffsTrain = _coeffsTrain;
-    return Criterion::getResult(xTrain, xTest, yTrain, yTest, secondCriterionType, tempValues);
+double SequentialCriterion::recalculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                                        const VectorXd& yTest, BufferValues& bufferValues) const {
+    return Criterion::getResult(xTrain, xTest, yTrain, yTest, secondCriterionType, bufferValues);
+}
+
+double SequentialCriterion::recalculate(const SplittedMoments& moments, const VectorU16& comb, 
+                                        BufferValues& bufferValues) const {
+    return Criterion::getResult(moments, comb, secondCriterionType, bufferValues);
+}
+
+bool SequentialCriterion::isRecalculated() const {
+    return true;
+}
+
+int SequentialCriterion::usedFolds() const {
+    return std::max(Criterion::usedFolds(), Criterion::usedFolds(secondCriterionType));
+}
+
+bool SequentialCriterion::usesDataRows() const {
+    return Criterion::usesDataRows() || Criterion::usesDataRows(secondCriterionType);
+}
+
+bool Criterion::isRecalculated() const {
+    return false;
+}
+
+double Criterion::recalculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain,
+                              const VectorXd& yTest, BufferValues& bufferValues) const {
+    return calculate(xTrain, xTest, yTrain, yTest, bufferValues);
+}
+
+double Criterion::recalculate(const SplittedMoments& moments, const VectorU16& comb, BufferValues& bufferValues) const {
+    return calculate(moments, comb, bufferValues);
+}
+
+uint64_t Criterion::getSelectionSize(uint64_t combinationsNumber, int k) const {
+    return std::min(static_cast<uint64_t>(k), combinationsNumber);
 }
 
 VectorC Criterion::getBestCombinations(VectorC& combinations, const SplittedData& data,
     const std::function<MatrixXd(const MatrixXd&, const VectorU16&)> func, int k) const {
     k = std::min(k, static_cast<int>(combinations.size()));
-    VectorC _bestCombinations{ std::begin(combinations), std::begin(combinations) + k };
-    std::sort(std::begin(_bestCombinations), std::end(_bestCombinations));
-    for (auto combBegin = std::begin(combinations) + k, combEnd = std::end(combinations);
-        combBegin != combEnd; ++combBegin) {
-        if ((*combBegin) < _bestCombinations.back()) {
-            std::swap(*combBegin, _bestCombinations.back());
-            std::sort(std::begin(_bestCombinations), std::end(_bestCombinations));
-        }
-    }
-    return _bestCombinations;
+    std::partial_sort(std::begin(combinations), std::begin(combinations) + k, std::end(combinations));
+    return VectorC(std::make_move_iterator(std::begin(combinations)), 
+                   std::make_move_iterator(std::begin(combinations) + k));
 }
 }
\ No newline at end of file
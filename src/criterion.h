@@ -10,7 +10,9 @@ class GmdhModel;
 enum class Solver { 
     fast, //!< Fast solution with perhaps not the best accuracy using HouseholderQR decomposition
     accurate, //!< Slow solution with maximum accuracy using FullPivHouseholderQR decomposition
-    balanced //!< Balanced solution with average speed and accuracy using ColPivHouseholderQR decomposition
+    balanced, //!< Balanced solution with average speed and accuracy using ColPivHouseholderQR decomposition
+    gram, //!< The fastest solution using the Cholesky decomposition of the Gram matrix. Linear models are trained and evaluated from the data moments precomputed once, so the cost of each model doesn't depend on the number of data rows
+    adaptive //!< Solution using HouseholderQR decomposition that is escalated to ColPivHouseholderQR decomposition if the diagonal of its R factor shows the rank deficiency or bad conditioning of the data, and to FullPivHouseholderQR decomposition if the data is rank deficient. The number of escalated models is reported by FitReport
 };
 
 /**
@@ -29,6 +31,15 @@ enum class Solver {
  * \f$ \hat{w}_A \f$ - coefficients vector of the model trained on a training data \f$ A \f$;\n
  * \f$ \hat{w}_B \f$ - coefficients vector of the model trained on a testing data \f$ B \f$;\n
  * \f$ \hat{w}_C \f$ - coefficients vector of the model trained on a learning data \f$ C \f$;\n
+ * \f$ h_i \f$ - diagonal element \f$ x_i^T(X_C^TX_C)^{-1}x_i \f$ of the hat matrix of the learning data for its row \f$ i \f$;\n
+ * \f$ C_k \f$ - fold \f$ k \f$ of \f$ K \f$ (CROSSVALIDATIONFOLDS) consecutive folds of the learning data \f$ C \f$;\n
+ * 
+ * The cross-validation criterion calculates the coefficients of each fold from the moments of the learning data 
+ * without the moments of the fold, so the models aren't trained again for each fold
+ * 
+ * The leave-one-out criterion is the predicted residual sum of squares (PRESS) of the learning data. It is equal to 
+ * the error of the models trained again without each row, but it is calculated from one decomposition of the learning data. 
+ * It needs the data rows, so Solver::gram evaluates the models using their data instead of the data moments
  */
 enum class CriterionType {
     regularity, //!< \f$ E=||y_{B}-X_{B}\hat{w}_A||^2 \f$
@@ -39,18 +50,95 @@ enum class CriterionType {
     symUnbiasedOutputs, //!< \f$ E=||X_{C}\hat{w}_A-X_{C}\hat{w}_B||^2 \f$
     unbiasedCoeffs, //!< \f$ E=||\hat{w}_A-\hat{w}_B||^2 \f$
     absoluteNoiseImmunity, //!< \f$ E=(X_B\hat{w}_C-X_B\hat{w}_A)^T(X_B\hat{w}_B-X_B\hat{w}_C) \f$
-    symAbsoluteNoiseImmunity //!< \f$ E=(X_C\hat{w}_C-X_C\hat{w}_A)^T(X_C\hat{w}_B-X_C\hat{w}_C) \f$
-}; // TODO: maybe add cross validation criterion
+    symAbsoluteNoiseImmunity, //!< \f$ E=(X_C\hat{w}_C-X_C\hat{w}_A)^T(X_C\hat{w}_B-X_C\hat{w}_C) \f$
+    crossValidation, //!< \f$ E=\sum_{k=1}^{K}||y_{C_k}-X_{C_k}\hat{w}_{C\setminus{C_k}}||^2 \f$
+    leaveOneOut //!< \f$ E=\sum_{i\in{C}}\left(\frac{y_i-x_i^T\hat{w}_C}{1-h_i}\right)^2 \f$
+};
+
+/**
+ * @brief Structure for storing the QR decompositions of the solvers for one type of the input matrix
+ * 
+ * @tparam MatrixType Type of the decomposed matrix. The decompositions of the matrices with the fixed number of columns 
+ * keep their coefficients and permutations on the stack
+ */
+template <typename MatrixType>
+struct QRDecompositions {
+    HouseholderQR<MatrixType> householderQr; //!< Decomposition used by the fast solver
+    ColPivHouseholderQR<MatrixType> colPivHouseholderQr; //!< Decomposition used by the balanced solver
+    FullPivHouseholderQR<MatrixType> fullPivHouseholderQr; //!< Decomposition used by the accurate solver
+};
 
-/// @brief Structure for storing coefficients and predicted values calculated in different ways
+/**
+ * @brief Structure for storing the memory reused by the evaluations of the models in one thread
+ * 
+ * The models of one level have the same number of rows and usually the same number of columns, 
+ * so the matrices, the moments and the decompositions keep their allocated memory between the models
+ */
+struct EvaluationWorkspace {
+    MatrixXd xTrain; //!< Input variables matrix of the training data for the evaluated model
+    MatrixXd xTest; //!< Input variables matrix of the testing data for the evaluated model
+    MatrixXd xAll; //!< Input variables matrix of the learning data for the evaluated model
+    VectorXd yAll; //!< Target values vector of the learning data
+    VectorXd qty; //!< Product of the transposed Q factor and the target values vector
+    QRDecompositions<MatrixXd> decompositions; //!< Decompositions of the data whose number of columns has no fixed-width decompositions
+    std::tuple<QRDecompositions<Matrix<double, Dynamic, 2> >, QRDecompositions<Matrix<double, Dynamic, 3> >, 
+               QRDecompositions<Matrix<double, Dynamic, 4> >, QRDecompositions<Matrix<double, Dynamic, 5> >, 
+               QRDecompositions<Matrix<double, Dynamic, 6> >, QRDecompositions<Matrix<double, Dynamic, 7> >, 
+               QRDecompositions<Matrix<double, Dynamic, 8> > > fixedDecompositions; //!< Decompositions of the data with the usual numbers of columns from 2 to 8
+    Solver decomposition{ Solver::fast }; //!< Solver whose decomposition contains the last decomposed data. It can differ from the selected one for Solver::adaptive
+    IncrementalCholesky cholesky; //!< Decomposition of the data moments with more than 8 columns
+    SplittedMoments moments; //!< Moments of the model data calculated by the criteria that use them with the data rows
+    DataMoments solvedMoments; //!< Moments of the system that aren't stored elsewhere, e.g. of the learning data without one fold
+    VectorXd foldCoeffs; //!< Coefficients vector of the model trained without one fold
+    VectorXd difference; //!< Difference of the coefficients vectors of the model
+    VectorXd secondDifference; //!< Difference of the other coefficients vectors of the model
+    VectorXd orderedCoeffs; //!< Coefficients vector in the order of the columns of the incremental decomposition
+    MatrixXd hatFactor; //!< Product of the model data and the inverse upper triangular factor of its decomposition
+    VectorXd leverages; //!< Diagonal elements of the hat matrix of the model data
+    VectorU16 cols; //!< Consecutive indexes of the model data columns
+
+    /**
+     * @brief Get the indexes of all columns of the model data
+     * 
+     * @param size The number of columns
+     * @return Vector of the consecutive indexes starting from 0. It is changed by the next calls with other sizes
+     */
+    const VectorU16& allCols(size_t size) {
+        if (cols.size() != size) { // the same size is returned without writing, so the result can be passed as the comb
+            cols.resize(size);
+            std::iota(std::begin(cols), std::end(cols), 0);
+        }
+        return cols;
+    }
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+/**
+ * @brief Structure for storing coefficients calculated in different ways
+ * 
+ * The vectors keep their memory between the models, the flags show which of them are calculated for the current model. 
+ * Predicted values aren't stored: the criterions calculate them together with the residuals in one pass over the data
+ */
 struct BufferValues {
-    VectorXd coeffsTrain; //!< Coefficients vector calculated using training data
+    VectorXd coeffsTrain; //!< Coefficients vector calculated using training data. It contains the coefficients of the model after the criterion calculation
     VectorXd coeffsTest; //!< Coefficients vector calculated using testing data
     VectorXd coeffsAll; //!< Coefficients vector calculated using learning data
-    VectorXd yPredTrainByTrain; //!< Predicted values for *training* data calculated using coefficients vector calculated on *training* data
-    VectorXd yPredTrainByTest; //!< Predicted values for *training* data calculated using coefficients vector calculated on *testing* data
-    VectorXd yPredTestByTrain; //!< Predicted values for *testing* data calculated using coefficients vector calculated on *training* data
-    VectorXd yPredTestByTest; //!< Predicted values for *testing* data calculated using coefficients vector calculated on *testing* data
+    bool isTrainSolved{ false }; //!< True if coeffsTrain is calculated for the current model
+    bool isTestSolved{ false }; //!< True if coeffsTest is calculated for the current model
+    bool isAllSolved{ false }; //!< True if coeffsAll is calculated for the current model
+    bool isEscalated{ false }; //!< True if some decomposition of the current model was escalated by Solver::adaptive, so the model is counted once
+    EvaluationWorkspace& workspace; //!< Memory reused between the models of one thread
+
+    /**
+     * @brief Construct a new BufferValues object
+     * 
+     * @param _workspace Memory reused between the models of one thread
+     */
+    explicit BufferValues(EvaluationWorkspace& _workspace) : workspace(_workspace) {}
+
+    /// @brief Mark all coefficients as not calculated and the model as not escalated before the evaluation of the next model
+    void reset() { isTrainSolved = isTestSolved = isAllSolved = isEscalated = false; }
 };
 
 /// @brief Class that implements calculations of internal and individual external criterions
@@ -65,9 +153,114 @@ protected:
      * 
      * @param xTrain Matrix of input variables that should be used to calculate the model coefficients
      * @param yTrain Target values vector for the corresponding xTrain parameter
-     * @return Coefficients vector representing a solution of the linear equations system constructed from the parameters data
+     * @param coeffs Vector to which the coefficients representing a solution of the linear equations system 
+     * constructed from the parameters data will be written
+     * @param workspace Memory for the decompositions reused between the models
+     */
+    void findBestCoeffs(const MatrixXd& xTrain, const VectorXd& yTrain, VectorXd& coeffs, EvaluationWorkspace& workspace) const;
+
+    /**
+     * @brief Mark the model as escalated if the last decomposition of its workspace was escalated by Solver::adaptive
+     * 
+     * @param bufferValues Temporary storage for the coefficients of the model and its workspace
+     */
+    void checkEscalation(BufferValues& bufferValues) const;
+
+    /**
+     * @brief Implements the internal criterion calculation using the learning data
+     * 
+     * @param xTrain Input variables matrix of the training data
+     * @param xTest Input variables matrix of the testing data
+     * @param yTrain Target values vector of the training data
+     * @param yTest Target values vector of the testing data
+     * @param coeffs Vector to which the coefficients representing a solution of the linear equations system 
+     * constructed from the learning data will be written
+     * @param workspace Memory for the learning data and the decompositions reused between the models
+     */
+    void findBestCoeffs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest, 
+                        VectorXd& coeffs, EvaluationWorkspace& workspace) const;
+
+    /**
+     * @brief Implements the internal criterion calculation using the decompositions of the given matrix type.
+     * 
+     * The steps are the same as in the solve() methods of the decompositions, but the right side is transformed in place
+     * 
+     * @tparam MatrixType Type of the decomposed matrix
+     * @param xTrain Matrix of input variables that should be used to calculate the model coefficients
+     * @param yTrain Target values vector for the corresponding xTrain parameter
+     * @param decompositions Decompositions of the workspace for the number of columns of the xTrain matrix
+     * @param workspace Memory for the transformed right side reused between the models
+     * @param coeffs Vector to which the coefficients will be written
+     * @param _solver Solver whose decomposition is computed. Solver::adaptive chooses the decomposition by the conditioning
+     */
+    template <typename MatrixType>
+    void findBestCoeffs(const MatrixXd& xTrain, const VectorXd& yTrain, QRDecompositions<MatrixType>& decompositions, 
+                        EvaluationWorkspace& workspace, VectorXd& coeffs, Solver _solver) const;
+
+    /**
+     * @brief Implements the internal criterion calculation using the data moments
+     * 
+     * @param moments Moments of the data that should be used to calculate the model coefficients
+     * @param comb Indexes of the data columns used in the model
+     * @param coeffs Vector to which the coefficients representing a least squares solution for the given columns will be written. 
+     * Columns linearly dependent on the previous ones get zero coefficients
+     * @param workspace Memory for the decomposition of the models with many columns
+     */
+    void findBestCoeffs(const DataMoments& moments, const VectorU16& comb, VectorXd& coeffs, EvaluationWorkspace& workspace) const;
+
+    /**
+     * @brief Implements the internal criterion calculation for the batch of models using their data moments
+     * 
+     * @param moments Moments of the data of each model. All models have the same number of columns and use all of them
+     * @param count The number of models in the batch, no more than BATCHSIZE
+     * @param coeffs Array to which the coefficients vectors of the models will be written
+     * @return True if the batch is solved, false if its number of columns isn't supported by the batched solver
+     */
+    bool findBestCoeffs(const DataMoments* const moments[], int count, VectorXd coeffs[]) const;
+
+    /**
+     * @brief Calculate the residual sums of squares for the batch of models using their data moments
+     * 
+     * @param moments Moments of the data of each model. All models have the same number of columns and use all of them
+     * @param count The number of models in the batch, no more than BATCHSIZE
+     * @param coeffs Coefficients vectors of the models
+     * @param rss Array to which the residual sums of squares of the models will be written
+     * @return True if the sums are calculated, false if the number of columns isn't supported by the batched solver
+     */
+    bool residualsSquares(const DataMoments* const moments[], int count, const VectorXd coeffs[], double rss[]) const;
+
+    /**
+     * @brief Get the coefficients vector calculated using training data, it is calculated if it isn't calculated for the model yet
+     * 
+     * @param xTrain Input variables matrix of the training data
+     * @param yTrain Target values vector of the training data
+     * @param bufferValues Storage for the coefficients
+     * @return Reference to the coefficients vector stored in bufferValues
      */
-    VectorXd findBestCoeffs(const MatrixXd& xTrain, const VectorXd& yTrain) const;
+    const VectorXd& coeffsTrain(const MatrixXd& xTrain, const VectorXd& yTrain, BufferValues& bufferValues) const;
+
+    /**
+     * @brief Get the coefficients vector calculated using testing data, it is calculated if it isn't calculated for the model yet
+     * 
+     * @param xTest Input variables matrix of the testing data
+     * @param yTest Target values vector of the testing data
+     * @param bufferValues Storage for the coefficients
+     * @return Reference to the coefficients vector stored in bufferValues
+     */
+    const VectorXd& coeffsTest(const MatrixXd& xTest, const VectorXd& yTest, BufferValues& bufferValues) const;
+
+    /**
+     * @brief Get the coefficients vector calculated using learning data, it is calculated if it isn't calculated for the model yet
+     * 
+     * @param xTrain Input variables matrix of the training data
+     * @param xTest Input variables matrix of the testing data
+     * @param yTrain Target values vector of the training data
+     * @param yTest Target values vector of the testing data
+     * @param bufferValues Storage for the coefficients
+     * @return Reference to the coefficients vector stored in bufferValues
+     */
+    const VectorXd& coeffsAll(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest, 
+                              BufferValues& bufferValues) const;
 
     /**
      * @brief Calculate the value of the selected external criterion for the given data
@@ -77,11 +270,40 @@ protected:
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
      * @param _criterionType Selected external criterion type
-     * @param bufferValues Temporary storage for calculated coefficients and target values
-     * @return The value of external criterion and calculated model coefficients
+     * @param bufferValues Temporary storage for calculated coefficients
+     * @return The value of external criterion
+     */
+    double getResult(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest, 
+                     CriterionType _criterionType, BufferValues& bufferValues) const;
+
+    /**
+     * @brief Calculate the value of the selected external criterion using the data moments
+     * 
+     * @param moments Moments of the training, testing and learning data
+     * @param comb Indexes of the data columns used in the model
+     * @param _criterionType Selected external criterion type
+     * @param bufferValues Temporary storage for calculated coefficients
+     * @return The value of external criterion
+     */
+    double getResult(const SplittedMoments& moments, const VectorU16& comb, CriterionType _criterionType, 
+                     BufferValues& bufferValues) const;
+
+    /**
+     * @brief Calculate the values of the selected external criterion for the batch of models using their data moments
+     * 
+     * Only the criteria that are the residual sums of squares of the found coefficients are calculated for the batch, 
+     * so their reductions use the same lanes as the batched solver
+     * 
+     * @param moments Moments of the training, testing and learning data of each model. All their columns are used in the models
+     * @param count The number of models in the batch, no more than BATCHSIZE
+     * @param coeffsTrain Coefficients vectors of the models calculated using training data
+     * @param coeffsTest Coefficients vectors of the models calculated using testing data. They are used by the symmetric criteria
+     * @param _criterionType Selected external criterion type
+     * @param results Array to which the values of the external criterion will be written
+     * @return True if the values are calculated, false if the criterion should be calculated by getResult() for each model
      */
-    PairDVXd getResult(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest, 
-                       CriterionType _criterionType, BufferValues& bufferValues) const;
+    bool getResults(const SplittedMoments* const moments[], int count, const VectorXd coeffsTrain[], 
+                    const VectorXd coeffsTest[], CriterionType _criterionType, double results[]) const;
 
     /**
      * @brief Calculate the regularity external criterion for the given data
@@ -90,12 +312,12 @@ protected:
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @param bufferValues Temporary storage for calculated coefficients and target values
+     * @param bufferValues Temporary storage for calculated coefficients
      * @param inverseSplit True, if it is necessary to swap the roles of training and testing data, otherwise false
-     * @return The value of the regularity external criterion and calculated model coefficients
+     * @return The value of the regularity external criterion
      */
-    PairDVXd regularity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest, 
-                        BufferValues& bufferValues, bool inverseSplit = false) const;
+    double regularity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest, 
+                      BufferValues& bufferValues, bool inverseSplit = false) const;
 
     /**
      * @brief Calculate the symmetric regularity external criterion for the given data
@@ -104,11 +326,11 @@ protected:
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @param bufferValues Temporary storage for calculated coefficients and target values
-     * @return The value of the symmertic regularity external criterion and calculated model coefficients
+     * @param bufferValues Temporary storage for calculated coefficients
+     * @return The value of the symmertic regularity external criterion
      */
-    PairDVXd symRegularity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest, 
-                           BufferValues& bufferValues) const;
+    double symRegularity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest, 
+                         BufferValues& bufferValues) const;
 
     /**
      * @brief Calculate the stability external criterion for the given data
@@ -117,12 +339,12 @@ protected:
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @param bufferValues Temporary storage for calculated coefficients and target values
+     * @param bufferValues Temporary storage for calculated coefficients
      * @param inverseSplit True, if it is necessary to swap the roles of training and testing data, otherwise false
-     * @return The value of the stability external criterion and calculated model coefficients
+     * @return The value of the stability external criterion
      */
-    PairDVXd stability(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
-                       BufferValues& bufferValues, bool inverseSplit = false) const;
+    double stability(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
+                     BufferValues& bufferValues, bool inverseSplit = false) const;
 
     /**
      * @brief Calculate the symmetric stability external criterion for the given data
@@ -131,11 +353,11 @@ protected:
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @param bufferValues Temporary storage for calculated coefficients and target values
-     * @return The value of the symmertic stability external criterion and calculated model coefficients
+     * @param bufferValues Temporary storage for calculated coefficients
+     * @return The value of the symmertic stability external criterion
      */
-    PairDVXd symStability(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
-                          BufferValues& bufferValues) const;
+    double symStability(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
+                        BufferValues& bufferValues) const;
 
     /**
      * @brief Calculate the unbiased outputs external criterion for the given data
@@ -144,11 +366,11 @@ protected:
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @param bufferValues Temporary storage for calculated coefficients and target values
-     * @return The value of the unbiased outputs external criterion and calculated model coefficients
+     * @param bufferValues Temporary storage for calculated coefficients
+     * @return The value of the unbiased outputs external criterion
      */
-    PairDVXd unbiasedOutputs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
-                             BufferValues& bufferValues) const;
+    double unbiasedOutputs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
+                           BufferValues& bufferValues) const;
 
     /**
      * @brief Calculate the symmetric unbiased outputs external criterion for the given data
@@ -157,11 +379,11 @@ protected:
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @param bufferValues Temporary storage for calculated coefficients and target values
-     * @return The value of the symmetric unbiased outputs external criterion and calculated model coefficients 
+     * @param bufferValues Temporary storage for calculated coefficients
+     * @return The value of the symmetric unbiased outputs external criterion
      */
-    PairDVXd symUnbiasedOutputs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
-                                BufferValues& bufferValues) const;
+    double symUnbiasedOutputs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
+                              BufferValues& bufferValues) const;
 
     /**
      * @brief Calculate the unbiased coefficients external criterion for the given data
@@ -170,11 +392,11 @@ protected:
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @param bufferValues Temporary storage for calculated coefficients and target values
-     * @return The value of the unbiased coefficients external criterion and calculated model coefficients  
+     * @param bufferValues Temporary storage for calculated coefficients
+     * @return The value of the unbiased coefficients external criterion
      */
-    PairDVXd unbiasedCoeffs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
-                            BufferValues& bufferValues) const;
+    double unbiasedCoeffs(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
+                          BufferValues& bufferValues) const;
 
     /**
      * @brief Calculate the absolute noise immunity external criterion for the given data
@@ -183,11 +405,11 @@ protected:
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @param bufferValues Temporary storage for calculated coefficients and target values 
-     * @return The value of the absolute noise immunity external criterion and calculated model coefficients 
+     * @param bufferValues Temporary storage for calculated coefficients 
+     * @return The value of the absolute noise immunity external criterion
      */
-    PairDVXd absoluteNoiseImmunity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
-                               BufferValues& bufferValues) const;
+    double absoluteNoiseImmunity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
+                             BufferValues& bufferValues) const;
 
     /**
      * @brief Calculate the symmetric absolute noise immunity external criterion for the given data
@@ -196,23 +418,115 @@ protected:
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @param bufferValues Temporary storage for calculated coefficients and target values 
-     * @return The value of the symmetric absolute noise immunity external criterion and calculated model coefficients 
+     * @param bufferValues Temporary storage for calculated coefficients 
+     * @return The value of the symmetric absolute noise immunity external criterion
+     */
+    double symAbsoluteNoiseImmunity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
+                                BufferValues& bufferValues) const;
+
+    /**
+     * @brief Calculate the cross-validation external criterion for the given data
+     * 
+     * @param xTrain Input variables matrix of the training data
+     * @param xTest Input variables matrix of the testing data
+     * @param yTrain Target values vector of the training data
+     * @param yTest Target values vector of the testing data
+     * @param bufferValues Temporary storage for calculated coefficients
+     * @return The value of the cross-validation external criterion
+     */
+    double crossValidation(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
+                           BufferValues& bufferValues) const;
+
+    /**
+     * @brief Calculate the cross-validation external criterion using the moments of the folds of the learning data
+     * 
+     * @param moments Moments of the learning data and its folds
+     * @param comb Indexes of the data columns used in the model
+     * @param workspace Memory for the moments and the coefficients of the folds reused between the models
+     * @return The sum of the residual sums of squares of the folds
+     */
+    double crossValidation(const SplittedMoments& moments, const VectorU16& comb, EvaluationWorkspace& workspace) const;
+
+    /**
+     * @brief Calculate the leave-one-out external criterion for the given data
+     * 
+     * @param xTrain Input variables matrix of the training data
+     * @param xTest Input variables matrix of the testing data
+     * @param yTrain Target values vector of the training data
+     * @param yTest Target values vector of the testing data
+     * @param bufferValues Temporary storage for calculated coefficients
+     * @return The value of the leave-one-out external criterion
      */
-    PairDVXd symAbsoluteNoiseImmunity(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
-                                  BufferValues& bufferValues) const;
+    double leaveOneOut(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest,
+                       BufferValues& bufferValues) const;
+
+    /**
+     * @brief Calculate the predicted residual sum of squares using the diagonal of the hat matrix
+     * 
+     * @param x Input variables matrix of the data
+     * @param y Target values vector of the data
+     * @param coeffs Coefficients vector of the least squares solution on the data
+     * @param leverages Diagonal elements of the hat matrix of the data
+     * @return The sum of the squared leave-one-out residuals or the maximum double value if some row 
+     * can't be predicted by the model trained on the other rows
+     */
+    static double predictedResidualsSquare(const MatrixXd& x, const VectorXd& y, const VectorXd& coeffs, 
+                                           const VectorXd& leverages);
+
+    /**
+     * @brief Get the number of models that should be saved after the evaluation of all models of the level
+     * 
+     * @param combinationsNumber The number of all models of the level
+     * @param k Number of best models
+     * @return The number of models with the best values of the external criterion that should be passed to getBestCombinations() method
+     */
+    virtual uint64_t getSelectionSize(uint64_t combinationsNumber, int k) const;
 
     /**
      * @brief Get k models from the given ones with the best values of the external criterion
      * 
-     * @param combinations Vector of the trained models
+     * @param combinations Vector of the trained models remaining after the selection by getSelectionSize() number
      * @param data Object containing parts of a split dataset used in model training. Parameter is used in sequential criterion
      * @param func Function returning the new X train and X test data constructed from the original data using given combination of input variables column indexes. Parameter is used in sequential criterion
      * @param k Number of best models
-     * @return Vector containing k best models
+     * @return Vector containing k best models in ascending order of the external criterion values. 
+     * The selected models are moved from the given vector
      */
     virtual VectorC getBestCombinations(VectorC& combinations, const SplittedData& data, const std::function<MatrixXd(const MatrixXd&, const VectorU16&)> func, int k) const;
 
+    /**
+     * @brief Check whether the models remaining after the selection by getSelectionSize() number are evaluated again 
+     * by recalculate() method before getBestCombinations() method
+     * 
+     * @return True if the criterion is recalculated for the remaining models
+     */
+    virtual bool isRecalculated() const;
+
+    /**
+     * @brief Recalculate the value of the external criterion for the remaining model.
+     * 
+     * For the individual criterion this method only calls the calculate() method
+     * 
+     * @param xTrain Input variables matrix of the training data
+     * @param xTest Input variables matrix of the testing data
+     * @param yTrain Target values vector of the training data
+     * @param yTest Target values vector of the testing data
+     * @param bufferValues Coefficients kept after the evaluation of the model. The missing ones are calculated
+     * @return The value of the external criterion
+     */
+    virtual double recalculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
+                               const VectorXd& yTest, BufferValues& bufferValues) const;
+
+    /**
+     * @brief Recalculate the value of the external criterion for the remaining model using the data moments
+     * 
+     * @param moments Moments of the training, testing and learning data
+     * @param comb Indexes of the data columns used in the model
+     * @param bufferValues Coefficients kept after the evaluation of the model. The missing ones are calculated
+     * @return The value of the external criterion
+     */
+    virtual double recalculate(const SplittedMoments& moments, const VectorU16& comb, BufferValues& bufferValues) const;
+
     /**
      * @brief Calculate the value of the selected external criterion for the given data.
      * 
@@ -222,10 +536,124 @@ protected:
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @return The value of the external criterion and calculated model coefficients 
+     * @param bufferValues Storage for the coefficients. Already calculated coefficients are used as is
+     * @return The value of the external criterion
+     */
+    virtual double calculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
+                             const VectorXd& yTest, BufferValues& bufferValues) const;
+
+    /**
+     * @brief Calculate the value of the selected external criterion using the data moments
+     * 
+     * @param moments Moments of the training, testing and learning data
+     * @param comb Indexes of the data columns used in the model
+     * @param bufferValues Storage for the coefficients. Already calculated coefficients are used as is
+     * @return The value of the external criterion
+     */
+    virtual double calculate(const SplittedMoments& moments, const VectorU16& comb, BufferValues& bufferValues) const;
+
+    /**
+     * @brief Calculate the values of the selected external criterion for the batch of models using their data moments
+     * 
+     * @param moments Moments of the training, testing and learning data of each model. All their columns are used in the models
+     * @param count The number of models in the batch, no more than BATCHSIZE
+     * @param coeffsTrain Coefficients vectors of the models calculated using training data
+     * @param coeffsTest Coefficients vectors of the models calculated using testing data if they are used by the criterion
+     * @param evaluations Array to which the values of the external criterion will be written
+     * @return True if the values are calculated, false if the criterion should be calculated for each model
+     */
+    virtual bool calculate(const SplittedMoments* const moments[], int count, const VectorXd coeffsTrain[], 
+                           const VectorXd coeffsTest[], double evaluations[]) const;
+
+    /**
+     * @brief Determine which coefficients vectors are used by the criterion besides the one calculated using training data
+     * 
+     * @param coeffsTest Set to true if the coefficients calculated using testing data are used
+     * @param coeffsAll Set to true if the coefficients calculated using learning data are used
+     */
+    virtual void usedCoeffs(bool& coeffsTest, bool& coeffsAll) const;
+
+    /**
+     * @brief Determine which coefficients vectors are used by the individual criterion besides the one calculated using training data
+     * 
+     * @param _criterionType Selected external criterion type
+     * @param coeffsTest Set to true if the coefficients calculated using testing data are used
+     * @param coeffsAll Set to true if the coefficients calculated using learning data are used
+     */
+    static void usedCoeffs(CriterionType _criterionType, bool& coeffsTest, bool& coeffsAll);
+
+    /**
+     * @brief Get the number of folds of the learning data whose moments are used by the criterion
+     * 
+     * @return The number of folds or 0 if the criterion doesn't use them
+     */
+    virtual int usedFolds() const;
+
+    /**
+     * @brief Get the number of folds of the learning data whose moments are used by the individual criterion
+     * 
+     * @param _criterionType Selected external criterion type
+     * @return The number of folds or 0 if the criterion doesn't use them
+     */
+    static int usedFolds(CriterionType _criterionType);
+
+    /**
+     * @brief Check whether the criterion needs the data rows and can't be calculated using the data moments
+     * 
+     * @return True if the models should be evaluated using their data with any solver
+     */
+    virtual bool usesDataRows() const;
+
+    /**
+     * @brief Check whether the individual criterion needs the data rows and can't be calculated using the data moments
+     * 
+     * @param _criterionType Selected external criterion type
+     * @return True if the models should be evaluated using their data with any solver
+     */
+    static bool usesDataRows(CriterionType _criterionType);
+
+    /**
+     * @brief Calculate the lower bound of the external criterion for all models using subsets of the same data columns.
+     * 
+     * Adding columns can't increase the least squares residual sum of squares, so the criteria comparing the target values 
+     * with the model outputs aren't less than the residual sums of squares of the least squares solution for all columns
+     * 
+     * @param rssTrain The least squares residual sum of squares for all columns on the training data
+     * @param rssTest The least squares residual sum of squares for all columns on the testing data
+     * @param rssAll The least squares residual sum of squares for all columns on the learning data
+     * @return The lower bound or the lowest double value if the criterion can't be bounded
+     */
+    virtual double getLowerBound(double rssTrain, double rssTest, double rssAll) const;
+
+    /**
+     * @brief Calculate the lower bound of the individual external criterion for all models using subsets of the same data columns
+     * 
+     * @param _criterionType Selected external criterion type
+     * @param rssTrain The least squares residual sum of squares for all columns on the training data
+     * @param rssTest The least squares residual sum of squares for all columns on the testing data
+     * @param rssAll The least squares residual sum of squares for all columns on the learning data
+     * @return The lower bound or the lowest double value if the criterion can't be bounded
+     */
+    static double getLowerBound(CriterionType _criterionType, double rssTrain, double rssTest, double rssAll);
+
+    /**
+     * @brief Determine which residual sums of squares are used by the lower bound of the criterion
+     * 
+     * @param rssTrain Set to true if the residual sum of squares on the training data is used
+     * @param rssTest Set to true if the residual sum of squares on the testing data is used
+     * @param rssAll Set to true if the residual sum of squares on the learning data is used
+     */
+    virtual void usedResiduals(bool& rssTrain, bool& rssTest, bool& rssAll) const;
+
+    /**
+     * @brief Determine which residual sums of squares are used by the lower bound of the individual criterion
+     * 
+     * @param _criterionType Selected external criterion type
+     * @param rssTrain Set to true if the residual sum of squares on the training data is used
+     * @param rssTest Set to true if the residual sum of squares on the testing data is used
+     * @param rssAll Set to true if the residual sum of squares on the learning data is used
      */
-    virtual PairDVXd calculate(const MatrixXd& xTrain, const MatrixXd& xTest, 
-                               const VectorXd& yTrain, const VectorXd& yTest) const;
+    static void usedResiduals(CriterionType _criterionType, bool& rssTrain, bool& rssTest, bool& rssAll);
 
 public:
     /// @brief Construct a new Criterion object
@@ -254,10 +682,40 @@ class GMDH_API ParallelCriterion : public Criterion {
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @return The value of the parallel external criterion and calculated model coefficients  
+     * @param bufferValues Storage for the coefficients. Already calculated coefficients are used as is
+     * @return The value of the parallel external criterion
      */
-    PairDVXd calculate(const MatrixXd& xTrain, const MatrixXd& xTest, 
-                       const VectorXd& yTrain, const VectorXd& yTest) const override;
+    double calculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
+                     const VectorXd& yTest, BufferValues& bufferValues) const override;
+
+    /**
+     * @brief Calculate the value of the selected parallel external criterion using the data moments
+     * 
+     * @param moments Moments of the training, testing and learning data
+     * @param comb Indexes of the data columns used in the model
+     * @param bufferValues Storage for the coefficients. Already calculated coefficients are used as is
+     * @return The value of the parallel external criterion
+     */
+    double calculate(const SplittedMoments& moments, const VectorU16& comb, BufferValues& bufferValues) const override;
+
+    /**
+     * @brief Calculate the values of the selected parallel external criterion for the batch of models using their data moments
+     * 
+     * @param moments Moments of the training, testing and learning data of each model. All their columns are used in the models
+     * @param count The number of models in the batch, no more than BATCHSIZE
+     * @param coeffsTrain Coefficients vectors of the models calculated using training data
+     * @param coeffsTest Coefficients vectors of the models calculated using testing data if they are used by the criterion
+     * @param evaluations Array to which the values of the parallel external criterion will be written
+     * @return True if the values are calculated, false if any of the criteria should be calculated for each model
+     */
+    bool calculate(const SplittedMoments* const moments[], int count, const VectorXd coeffsTrain[], 
+                   const VectorXd coeffsTest[], double evaluations[]) const override;
+
+    void usedCoeffs(bool& coeffsTest, bool& coeffsAll) const override;
+    int usedFolds() const override;
+    bool usesDataRows() const override;
+    double getLowerBound(double rssTrain, double rssTest, double rssAll) const override;
+    void usedResiduals(bool& rssTrain, bool& rssTest, bool& rssAll) const override;
 public:
     /**
      * @brief Construct a new ParallelCriterion object
@@ -272,35 +730,54 @@ public:
                         double _alpha = 0.5, Solver _solver = Solver::balanced);
 };
 
-/// @brief Class that implements calculations of sequential external criterions
+/**
+ * @brief Class that implements calculations of sequential external criterions
+ * 
+ * The models with the best values of the first criterion are kept in memory until all models of the level are evaluated,
+ * and then they are evaluated using the second criterion. If the top value is less than the number of the best models,
+ * about half of the level models remain. Their number can be limited by the top limit to bound the memory of the large levels
+ */
 class GMDH_API SequentialCriterion : public Criterion {
     CriterionType secondCriterionType; //!< Selected second CriterionType object
     int top; //!< Number of models that should remain after applying the first individual external criterion
+    int topLimit; //!< The maximum number of models remaining after applying the first criterion if the top value is less than the number of the best models, or 0 if it isn't limited
 
     /**
-     * @brief Calculate the second external criterion for the remaining models
+     * @brief Calculate the second external criterion for the remaining model
      * 
      * @param xTrain Input variables matrix of the training data
      * @param xTest Input variables matrix of the testing data
      * @param yTrain Target values vector of the training data
      * @param yTest Target values vector of the testing data
-     * @param _coeffsTrain Coefficients vector calculated using training data obtained during the calculation of the first criterion
-     * @return The final value of the sequential external criterion and calculated model coefficients
+     * @param bufferValues Coefficients calculated during the calculation of the first criterion. The missing ones are calculated
+     * @return The final value of the sequential external criterion
      */
-    PairDVXd recalculate(const MatrixXd& xTrain, const MatrixXd& xTest,
-        const VectorXd& yTrain, const VectorXd& yTest, const VectorXd& _coeffsTrain) const;
-    
+    double recalculate(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
+                       const VectorXd& yTest, BufferValues& bufferValues) const override;
+
     /**
-     * @brief Get k models from the given ones with the best values of the sequential external criterion
+     * @brief Calculate the second external criterion for the remaining model using the data moments
      * 
-     * @param combinations Vector of the trained models
-     * @param data Object containing parts of a split dataset used in model training
-     * @param func Function returning the new X train and X test data constructed from the original data using given combination of input variables column indexes
-     * @param k Number of best models
-     * @return VectorC Vector containing k best models
+     * @param moments Moments of the training, testing and learning data
+     * @param comb Indexes of the data columns used in the model
+     * @param bufferValues Coefficients calculated during the calculation of the first criterion. The missing ones are calculated
+     * @return The final value of the sequential external criterion
+     */
+    double recalculate(const SplittedMoments& moments, const VectorU16& comb, BufferValues& bufferValues) const override;
+
+    bool isRecalculated() const override;
+    int usedFolds() const override;
+    bool usesDataRows() const override;
+
+    /**
+     * @brief Get the number of models that should be evaluated using the second individual external criterion
      * 
+     * @param combinationsNumber The number of all models of the level
+     * @param k Number of best models
+     * @return The top value if it isn't less than k, otherwise about half of the models of the level, but not more than 
+     * the top limit if it is set and isn't less than k
      */
-    VectorC getBestCombinations(VectorC& combinations, const SplittedData& data, const std::function<MatrixXd(const MatrixXd&, const VectorU16&)> func, int k) const override;
+    uint64_t getSelectionSize(uint64_t combinationsNumber, int k) const override;
 public:
     /**
      * @brief Construct a new SequentialCriterion object
@@ -309,9 +786,11 @@ public:
      * @param _secondCriterionType Selected second individual external criterion type
      * @param _top Number of models that should remain after applying the first individual external criterion
      * @param _solver Selected method for linear equations solving
+     * @param _topLimit The maximum number of models remaining after applying the first criterion if the top value 
+     * is less than the number of the best models. If it is 0, about half of the models of each level remain
      * @throw std::invalid_argument
      */
     SequentialCriterion(CriterionType _firstCriterionType, CriterionType _secondCriterionType, 
-                        int _top=0, Solver _solver = Solver::balanced);
+                        int _top=0, Solver _solver = Solver::balanced, int _topLimit = 0);
 };
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "gmdh.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 
 namespace GMDH {
@@ -47,6 +49,439 @@ VectorVu16 GmdhModel::nChooseK(int n, int k) const {
     return combs;
 }
 
+CombinationsRange::CombinationsRange(int n, int k) : _n(n), _k(k), _size(binomial(n, k)) {}
+
+void CombinationsRange::combination(uint64_t index, VectorU16& comb) const {
+    comb.resize(_k);
+    auto element{ 0 };
+    for (auto i = 0; i < _k; ++i) { // skipping all combinations with the smaller element at the i-th position
+        for (auto count = binomial(_n - element - 1, _k - i - 1); index >= count; 
+            count = binomial(_n - element - 1, _k - i - 1)) {
+            index -= count;
+            ++element;
+        }
+        comb[i] = element++;
+    }
+    comb.push_back(_n);
+}
+
+void CombinationsRange::next(VectorU16& comb) const {
+    auto i{ _k - 1 };
+    while (i >= 0 && comb[i] == _n - _k + i) 
+        --i;
+    if (i < 0)
+        return;
+    ++comb[i];
+    for (auto j = i + 1; j < _k; ++j)
+        comb[j] = comb[j - 1] + 1;
+}
+
+uint64_t CombinationsRange::binomial(int n, int k) {
+    if (k < 0 || k > n)
+        return 0;
+    k = std::min(k, n - k);
+    uint64_t result{ 1 };
+    for (auto i = 0; i < k; ++i) { // result * (n - i) / (i + 1) is always an integer value
+        uint64_t numerator = n - i, denominator = i + 1, a = result, b = denominator;
+        while (b) { // greatest common divisor of result and denominator
+            a %= b;
+            std::swap(a, b);
+        }
+        result /= a;
+        numerator /= denominator / a;
+        if (result > std::numeric_limits<uint64_t>::max() / numerator)
+            throw std::overflow_error(COMBINATIONSOVERFLOWEXCEPTION);
+        result *= numerator;
+    }
+    return result;
+}
+
+Executor::Executor(int threads) : threadsNumber(threads == -1 ? 
+    static_cast<int>(std::max(1u, boost::thread::hardware_concurrency())) : threads > 0 ? threads : 
+    throw std::invalid_argument(getVariableName("threads", "n_jobs") + " value must be a positive integer or -1")), 
+    pool(threadsNumber) {}
+
+CancellationToken::CancellationToken(double timeLimit) : cancelled(false), hasDeadline(timeLimit != -1) {
+    if (timeLimit < 0 && hasDeadline)
+        throw std::invalid_argument(getVariableName("timeLimit", "time_limit") + " value must be non-negative or -1");
+    if (hasDeadline)
+        deadline = std::chrono::steady_clock::now() + 
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeLimit));
+}
+
+struct FileChunksReader::FileMapping {
+    boost::interprocess::file_mapping mapping;
+};
+
+FileChunksReader::FileChunksReader(const std::string& path, int cols, int64_t chunkRows) : colsNumber(cols), 
+    chunkRows(chunkRows), rowsNumber(0), nextRow(0) {
+    if (cols < 1)
+        throw std::invalid_argument(getVariableName("cols", "cols_number") + " value must be a positive integer");
+    if (chunkRows < 1)
+        throw std::invalid_argument(getVariableName("chunkRows", "chunk_rows") + " value must be a positive integer");
+    if (!boost::filesystem::is_regular_file(path))
+        throw FileException("Invalid argument: '" + path + "'");
+    auto rowSize{ static_cast<uintmax_t>(cols + 1) * sizeof(double) };
+    auto fileSize{ boost::filesystem::file_size(path) };
+    if (fileSize % rowSize != 0)
+        throw FileException(CORRUPTEDFILEEXCEPTION);
+    rowsNumber = fileSize / rowSize;
+    if (rowsNumber > 0) // the empty file can't be mapped
+        file = std::make_shared<FileMapping>(FileMapping{ 
+            boost::interprocess::file_mapping(path.c_str(), boost::interprocess::read_only) });
+}
+
+bool FileChunksReader::read(MatrixXd& x, VectorXd& y) {
+    if (nextRow >= rowsNumber)
+        return false;
+    auto rows{ std::min(chunkRows, rowsNumber - nextRow) };
+    auto rowSize{ static_cast<int64_t>(colsNumber + 1) * static_cast<int64_t>(sizeof(double)) };
+    boost::interprocess::mapped_region region(file->mapping, boost::interprocess::read_only, nextRow * rowSize, rows * rowSize);
+    Map<const Matrix<double, Dynamic, Dynamic, RowMajor> > values(static_cast<const double*>(region.get_address()), 
+                                                                  rows, colsNumber + 1);
+    x = values.leftCols(colsNumber);
+    y = values.col(colsNumber);
+    nextRow += rows;
+    return true;
+}
+
+void FileChunksReader::getShape(int64_t& rows, int& cols) {
+    rows = rowsNumber;
+    cols = colsNumber;
+}
+
+void CallbackChunksReader::getShape(int64_t& rows, int& cols) {
+    if (rowsNumber < 0 || colsNumber == 0) { // the data is assumed to be the same in all passes
+        MatrixXd x;
+        VectorXd y;
+        int64_t counted{ 0 };
+        rewind();
+        while (read(x, y)) {
+            if (counted == 0)
+                colsNumber = x.cols();
+            counted += x.rows();
+            if (rowsNumber >= 0) // the given number of rows isn't counted again
+                break;
+        }
+        if (rowsNumber < 0)
+            rowsNumber = counted;
+    }
+    rows = rowsNumber;
+    cols = colsNumber;
+}
+
+void ChunksScheduler::startSlice() {
+    _sliceStart = std::chrono::steady_clock::now();
+    _lastSize = 0; // the waiting time isn't a part of the chunk evaluation
+}
+
+bool ChunksScheduler::next(uint64_t& beginIndex, uint64_t& endIndex) {
+    auto now{ std::chrono::steady_clock::now() };
+    if (_lastSize > 0) { // the size grows gradually, so the short chunks at the start don't give an unreliable estimate
+        auto duration{ std::chrono::duration<double>(now - _lastStart).count() };
+        auto expectedSize{ duration > 0 ? _lastSize * CHUNKDURATION / duration : 2.0 * _lastSize };
+        _chunkSize = static_cast<uint64_t>(std::max(1.0, std::min(expectedSize, 2.0 * _lastSize)));
+    }
+    if (_started && _token && _token->isCancelled()) {
+        _finished = true;
+        return false;
+    }
+    if (std::chrono::duration<double>(now - _sliceStart).count() > TASKSLICEDURATION)
+        return false;
+    auto remainingNumber{ _size - std::min(_nextIndex->load(), _size) };
+    auto size{ std::max(uint64_t{ 1 }, std::min(_chunkSize, remainingNumber / (CHUNKSPERTHREAD * _tasksNumber))) };
+    beginIndex = _nextIndex->fetch_add(size);
+    if (beginIndex >= _size) {
+        _finished = true;
+        return false;
+    }
+    endIndex = std::min(beginIndex + size, _size);
+    _started = true;
+    _lastSize = endIndex - beginIndex;
+    _lastStart = now;
+    return true;
+}
+
+DataMoments::DataMoments(const MatrixXd& x, const VectorXd& y) : DataMoments() {
+    compute(x, y);
+}
+
+void DataMoments::compute(const Ref<const MatrixXd>& x, const Ref<const VectorXd>& y) {
+    rows = 0;
+    add(x, y);
+}
+
+void DataMoments::add(const Ref<const MatrixXd>& x, const Ref<const VectorXd>& y) {
+    if (rows == 0) { // the memory of the previous moments is reused
+        xx.setZero(x.cols(), x.cols());
+        xy.setZero(x.cols());
+        yy = 0;
+    }
+    xx.selfadjointView<Lower>().rankUpdate(x.transpose());
+    xx.triangularView<StrictlyUpper>() = xx.transpose();
+    xy.noalias() += x.transpose() * y;
+    yy += y.squaredNorm();
+    rows += x.rows();
+}
+
+DataMoments& DataMoments::operator+=(const DataMoments& other) {
+    if (rows == 0)
+        return *this = other;
+    xx += other.xx;
+    xy += other.xy;
+    yy += other.yy;
+    rows += other.rows;
+    return *this;
+}
+
+DataMoments& DataMoments::operator-=(const DataMoments& other) {
+    xx -= other.xx;
+    xy -= other.xy;
+    yy -= other.yy;
+    rows -= other.rows;
+    return *this;
+}
+
+double DataMoments::dot(const VectorU16& comb, const VectorXd& u, const VectorXd& v) const {
+    double result{ 0 };
+    for (size_t i = 0; i < comb.size(); ++i) {
+        double row{ 0 };
+        for (size_t j = 0; j < comb.size(); ++j)
+            row += xx(comb[j], comb[i]) * v[j];
+        result += u[i] * row;
+    }
+    return result;
+}
+
+double DataMoments::residualsSquare(const VectorU16& comb, const VectorXd& coeffs) const {
+    double projection{ 0 };
+    for (size_t i = 0; i < comb.size(); ++i)
+        projection += coeffs[i] * xy[comb[i]];
+    return std::max(0.0, yy - 2 * projection + dot(comb, coeffs, coeffs)); // rounding errors can make the result negative
+}
+
+DataMoments DataMoments::difference(const DataMoments& other, const VectorU16& comb) const {
+    DataMoments moments;
+    difference(other, comb, moments);
+    return moments;
+}
+
+void DataMoments::difference(const DataMoments& other, const VectorU16& comb, DataMoments& result) const {
+    result.xx = xx(comb, comb) - other.xx(comb, comb);
+    result.xy = xy(comb) - other.xy(comb);
+    result.yy = yy - other.yy;
+    result.rows = rows - other.rows;
+}
+
+SplittedMoments::SplittedMoments(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
+    const VectorXd& yTest, int foldsNumber) {
+    compute(xTrain, xTest, yTrain, yTest, foldsNumber);
+}
+
+void SplittedMoments::compute(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, 
+    const VectorXd& yTest, int foldsNumber) {
+    folds.resize(foldsNumber);
+    if (foldsNumber == 0) {
+        train.compute(xTrain, yTrain);
+        test.compute(xTest, yTest);
+    }
+    else
+        train.rows = test.rows = 0;
+    for (auto& fold : folds)
+        fold.rows = 0;
+    forEachFoldPart(xTrain.rows(), xTest.rows(), foldsNumber, [&](bool isTest, Index begin, Index rows, int fold) {
+        const auto& x{ isTest ? xTest : xTrain };
+        const auto& y{ isTest ? yTest : yTrain };
+        auto& part{ isTest ? test : train };
+        auto& foldMoments{ folds[fold] };
+        if (foldMoments.rows > 0) { // the second part of the fold containing the border is the first rows of the testing data
+            part.compute(x.middleRows(begin, rows), y.segment(begin, rows));
+            foldMoments += part;
+        }
+        else {
+            foldMoments.compute(x.middleRows(begin, rows), y.segment(begin, rows));
+            part += foldMoments;
+        }
+    });
+    all = train;
+    all += test;
+}
+
+bool IncrementalCholesky::append(const DataMoments& moments, uint16_t col) {
+    auto rank{ this->rank() };
+    if (_u.cols() <= rank) {
+        _u.conservativeResize(2 * rank + 4, 2 * rank + 4);
+        _z.conservativeResize(2 * rank + 4);
+    }
+    auto diagonal{ moments.xx(col, col) };
+    auto pivot{ diagonal };
+    for (auto i = 0; i < rank; ++i) { // solving U^T u = X^T x for the new column
+        auto value{ moments.xx(_cols[_included[i]], col) };
+        for (auto j = 0; j < i; ++j)
+            value -= _u(j, i) * _u(j, rank);
+        _u(i, rank) = value / _u(i, i);
+        pivot -= _u(i, rank) * _u(i, rank);
+    }
+    _cols.push_back(col);
+    if (!(pivot > MINRELATIVEPIVOT * diagonal)) // the column is linearly dependent on the included ones
+        return false;
+    _u(rank, rank) = std::sqrt(pivot);
+    auto value{ moments.xy[col] };
+    for (auto j = 0; j < rank; ++j)
+        value -= _u(j, rank) * _z[j];
+    _z[rank] = value / _u(rank, rank);
+    _included.push_back(size() - 1);
+    return true;
+}
+
+void IncrementalCholesky::pop() {
+    if (!_included.empty() && _included.back() == size() - 1)
+        _included.pop_back();
+    _cols.pop_back();
+}
+
+VectorXd IncrementalCholesky::coeffs() const {
+    VectorXd result;
+    coeffs(result);
+    return result;
+}
+
+void IncrementalCholesky::coeffs(VectorXd& result) const {
+    auto rank{ this->rank() };
+    result.setZero(size());
+    for (auto i = rank - 1; i >= 0; --i) { // solving U w = z, the solution is read from the positions of the included columns
+        auto value{ _z[i] };
+        for (auto j = i + 1; j < rank; ++j)
+            value -= _u(i, j) * result[_included[j]];
+        result[_included[i]] = value / _u(i, i);
+    }
+}
+
+VectorXd IncrementalCholesky::coeffs(const DataMoments& moments, const VectorU16& comb) {
+    VectorXd result;
+    coeffs(moments, comb, result);
+    return result;
+}
+
+void IncrementalCholesky::coeffs(const DataMoments& moments, const VectorU16& comb, VectorXd& result) {
+    auto prefixSize{ static_cast<int>(comb.size()) - 1 };
+    auto commonSize{ 0 };
+    while (commonSize < std::min(size(), prefixSize) && _cols[commonSize] == comb[commonSize])
+        ++commonSize;
+    while (size() > commonSize)
+        pop();
+    for (auto i = commonSize; i < prefixSize; ++i)
+        append(moments, comb[i]);
+    append(moments, comb.back());
+    coeffs(result);
+    pop();
+}
+
+double IncrementalCholesky::residualsSquare(const DataMoments& moments) const {
+    return std::max(0.0, moments.yy - _z.head(rank()).squaredNorm());
+}
+
+double IncrementalCholesky::residualsSquare(const DataMoments& moments, const VectorU16& cols) {
+    auto commonSize{ 0 };
+    while (commonSize < std::min(size(), static_cast<int>(cols.size())) && _cols[commonSize] == cols[commonSize])
+        ++commonSize;
+    while (size() > commonSize)
+        pop();
+    for (auto i = commonSize; i < static_cast<int>(cols.size()); ++i)
+        append(moments, cols[i]);
+    return residualsSquare(moments);
+}
+
+VectorXd IncrementalCholesky::leverages(const MatrixXd& x) const {
+    auto rank{ this->rank() };
+    MatrixXd z(x.rows(), rank);
+    for (auto i = 0; i < rank; ++i)
+        z.col(i) = x.col(_cols[_included[i]]);
+    _u.topLeftCorner(rank, rank).triangularView<Upper>().solveInPlace<OnTheRight>(z); // the rows of X U^{-1}
+    return z.rowwise().squaredNorm();
+}
+
+void IncrementalQR::reflect(int index, VectorXd& vector) const {
+    auto length{ vector.size() - index };
+    auto scale{ _tau[index] * _v.col(index).segment(index, length).dot(vector.tail(length)) };
+    vector.tail(length) -= scale * _v.col(index).segment(index, length);
+}
+
+bool IncrementalQR::append(const MatrixXd& x, const VectorXd& y, uint16_t col) {
+    auto rank{ this->rank() };
+    auto rows{ x.rows() };
+    if (size() == 0)
+        _qty = y;
+    if (_r.cols() <= rank) {
+        _v.conservativeResize(rows, 2 * rank + 4);
+        _tau.conservativeResize(2 * rank + 4);
+        _r.conservativeResize(2 * rank + 4, 2 * rank + 4);
+    }
+    _column = x.col(col);
+    for (auto i = 0; i < rank; ++i)
+        reflect(i, _column);
+    _cols.push_back(col);
+    if (rows <= rank || !(_column.tail(rows - rank).squaredNorm() > MINRELATIVEPIVOT * x.col(col).squaredNorm()))
+        return false; // the column is linearly dependent on the included ones
+
+    auto essential{ _v.col(rank).tail(rows - rank - 1) }; // the reflection vector is written to its place without a temporary
+    double beta;
+    _column.tail(rows - rank).makeHouseholder(essential, _tau[rank], beta);
+    _v(rank, rank) = 1;
+    _r.col(rank).head(rank) = _column.head(rank);
+    _r(rank, rank) = beta;
+    reflect(rank, _qty);
+    _included.push_back(size() - 1);
+    return true;
+}
+
+void IncrementalQR::pop() {
+    if (!_included.empty() && _included.back() == size() - 1) {
+        _included.pop_back();
+        reflect(rank(), _qty); // the Householder reflection is the inverse of itself
+    }
+    _cols.pop_back();
+}
+
+VectorXd IncrementalQR::coeffs() const {
+    VectorXd result;
+    coeffs(result);
+    return result;
+}
+
+void IncrementalQR::coeffs(VectorXd& result) const {
+    auto rank{ this->rank() };
+    result.resize(size());
+    result.head(rank) = _qty.head(rank);
+    _r.topLeftCorner(rank, rank).triangularView<Upper>().solveInPlace(result.head(rank));
+    result.tail(size() - rank).setZero();
+    for (auto i = rank - 1; i >= 0; --i) { // the positions of the included columns aren't less than their indexes
+        auto value{ result[i] };
+        result[i] = 0;
+        result[_included[i]] = value;
+    }
+}
+
+VectorXd IncrementalQR::coeffs(const MatrixXd& x, const VectorXd& y, const VectorU16& comb) {
+    VectorXd result;
+    coeffs(x, y, comb, result);
+    return result;
+}
+
+void IncrementalQR::coeffs(const MatrixXd& x, const VectorXd& y, const VectorU16& comb, VectorXd& result) {
+    auto prefixSize{ static_cast<int>(comb.size()) - 1 };
+    auto commonSize{ 0 };
+    while (commonSize < std::min(size(), prefixSize) && _cols[commonSize] == comb[commonSize])
+        ++commonSize;
+    while (size() > commonSize)
+        pop();
+    for (auto i = commonSize; i < prefixSize; ++i)
+        append(x, y, comb[i]);
+    append(x, y, comb.back());
+    coeffs(result);
+    pop();
+}
+
 double GmdhModel::getMeanCriterionValue(const VectorC& sortedCombinations, int k) const {
     k = std::min(k, static_cast<int>(sortedCombinations.size()));
     auto currLevelEvaluation{ 0. };
@@ -55,16 +490,503 @@ double GmdhModel::getMeanCriterionValue(const VectorC& sortedCombinations, int k
     return currLevelEvaluation / static_cast<double>(k);
 }
 
-void GmdhModel::polynomialsEvaluation(const SplittedData& data, const Criterion& criterion,
-    IterC beginCoeffsVec, IterC endCoeffsVec, std::atomic<int> *leftTasks, int verbose) const {
-    for (; beginCoeffsVec < endCoeffsVec; ++beginCoeffsVec) {
-        auto pairCoeffsEvaluation{ criterion.calculate(xDataForCombination(data.xTrain, beginCoeffsVec->combination()),
-                                                        xDataForCombination(data.xTest, beginCoeffsVec->combination()),
-                                                        data.yTrain, data.yTest) };
-        beginCoeffsVec->setEvaluation(pairCoeffsEvaluation.first);
-        beginCoeffsVec->setBestCoeffs(std::move(pairCoeffsEvaluation.second));
-        if (unlikely(verbose > 0))
-            --(*leftTasks);                
+void GmdhModel::runTasks(int tasksNumber, const std::function<void(int)>& task) const {
+    if (!threadPool) {
+        for (auto i = 0; i < tasksNumber; ++i)
+            task(i);
+        return;
+    }
+    std::vector<boost::unique_future<void> > futures;
+    futures.reserve(tasksNumber);
+    for (auto i = 0; i < tasksNumber; ++i) {
+        boost::packaged_task<void> pt([&task, i]() { task(i); });
+        futures.push_back(pt.get_future());
+        post(*threadPool, std::move(pt));
+    }
+    boost::when_all(std::begin(futures), std::end(futures)).get();
+}
+
+uint64_t GmdhModel::prepareCombinations(int n_cols) {
+    levelCombinations = generateCombinations(n_cols);
+    levelCombinationsRange = CombinationsRange();
+    return levelCombinations.size();
+}
+
+void GmdhModel::getCombination(uint64_t index, VectorU16& comb) const {
+    if (levelCombinations.empty())
+        levelCombinationsRange.combination(index, comb);
+    else
+        comb = levelCombinations[index];
+}
+
+void GmdhModel::nextCombination(uint64_t index, VectorU16& comb) const {
+    if (levelCombinations.empty())
+        levelCombinationsRange.next(comb);
+    else
+        comb = levelCombinations[index];
+}
+
+void GmdhModel::selectBestCombinations(VectorC& combinations, uint64_t number) const {
+    if (combinations.size() > number) {
+        std::nth_element(std::begin(combinations), std::begin(combinations) + number, std::end(combinations));
+        combinations.erase(std::begin(combinations) + number, std::end(combinations));
+    }
+}
+
+void GmdhModel::xDataForCombination(const MatrixXd& x, const VectorU16& comb, MatrixXd& result) const {
+    result = xDataForCombination(x, comb);
+}
+
+void GmdhModel::polynomialsEvaluation(const SplittedData& data, const Criterion& criterion, ChunksScheduler& chunks, 
+    uint64_t selectionSize, VectorC& bestCombinations, TaskProgress& progress) const {
+    VectorU16 comb, order;
+    EvaluationWorkspace workspace; // the memory of the models data, moments and decompositions is reused by all the models of the task
+    BufferValues bufferValues(workspace);
+    IncrementalCholesky choleskyTrain, choleskyTest, choleskyAll; // decompositions of the previous model structure
+    IncrementalQR qrTrain, qrTest, qrAll;
+    MatrixXd xAll;
+    VectorXd yAll;
+    bool useCoeffsTest, useCoeffsAll;
+    criterion.usedCoeffs(useCoeffsTest, useCoeffsAll);
+    for (auto criterionType : scoredCriteria) // the coefficients of the scored criteria are solved in the batches too
+        Criterion::usedCoeffs(criterionType, useCoeffsTest, useCoeffsAll);
+    auto foldsNumber{ usedFolds(criterion) };
+    auto isMoments{ criterion.solver == Solver::gram && !usesDataRows(criterion) };
+    auto keepsCoeffs{ criterion.isRecalculated() }; // the coefficients of the saved models are reused by recalculateCombinations()
+    std::array<VectorU16, BATCHSIZE> batchCombs; // the models whose systems are solved together
+    std::array<uint64_t, BATCHSIZE> batchIndexes;
+    std::array<SplittedMoments, BATCHSIZE> batchMoments;
+    std::array<VectorXd, BATCHSIZE> batchCoeffsTrain, batchCoeffsTest, batchCoeffsAll;
+    std::vector<bool> isBatchScored(scoredCriteria.size()); // the scored criteria calculated for the whole batch
+    auto batchSize{ 0 };
+    for (uint64_t beginIndex, endIndex; chunks.next(beginIndex, endIndex);) {
+        auto bestEvaluation{ std::numeric_limits<double>::max() };
+        auto evaluateBatch = [&]() { // the coefficients are found for all models of the batch, then the models are evaluated
+            const SplittedMoments* moments[BATCHSIZE];
+            const DataMoments* train[BATCHSIZE], * test[BATCHSIZE], * all[BATCHSIZE];
+            for (auto i = 0; i < batchSize; ++i) {
+                moments[i] = &batchMoments[i];
+                train[i] = &batchMoments[i].train;
+                test[i] = &batchMoments[i].test;
+                all[i] = &batchMoments[i].all;
+            }
+            auto isSolved{ criterion.findBestCoeffs(train, batchSize, batchCoeffsTrain.data()) };
+            if (isSolved && useCoeffsTest)
+                criterion.findBestCoeffs(test, batchSize, batchCoeffsTest.data());
+            if (isSolved && useCoeffsAll)
+                criterion.findBestCoeffs(all, batchSize, batchCoeffsAll.data());
+            double evaluations[BATCHSIZE], scores[BATCHSIZE]; // the residual sums of squares are reduced in the lanes of the solver
+            auto isEvaluated{ isSolved && criterion.calculate(moments, batchSize, batchCoeffsTrain.data(), 
+                                                              batchCoeffsTest.data(), evaluations) };
+            for (size_t j = 0; levelScores != nullptr && j < scoredCriteria.size(); ++j) {
+                isBatchScored[j] = isSolved && criterion.getResults(moments, batchSize, batchCoeffsTrain.data(), 
+                                                                    batchCoeffsTest.data(), scoredCriteria[j], scores);
+                for (auto i = 0; isBatchScored[j] && i < batchSize; ++i)
+                    (*levelScores)(batchIndexes[i], j) = scores[i];
+            }
+            for (auto i = 0; i < batchSize; ++i) {
+                bufferValues.reset();
+                if (isSolved) { // the vectors are swapped, so the memory of both of them is reused by the next models
+                    bufferValues.coeffsTrain.swap(batchCoeffsTrain[i]);
+                    bufferValues.isTrainSolved = true;
+                    if (useCoeffsTest) {
+                        bufferValues.coeffsTest.swap(batchCoeffsTest[i]);
+                        bufferValues.isTestSolved = true;
+                    }
+                    if (useCoeffsAll) {
+                        bufferValues.coeffsAll.swap(batchCoeffsAll[i]);
+                        bufferValues.isAllSolved = true;
+                    }
+                }
+                const auto& cols{ workspace.allCols(batchMoments[i].all.xx.cols()) };
+                auto evaluation{ isEvaluated ? evaluations[i] : criterion.calculate(batchMoments[i], cols, bufferValues) };
+                for (size_t j = 0; levelScores != nullptr && j < scoredCriteria.size(); ++j)
+                    if (!isBatchScored[j])
+                        (*levelScores)(batchIndexes[i], j) = criterion.getResult(batchMoments[i], cols, scoredCriteria[j], 
+                                                                                 bufferValues);
+                bestEvaluation = std::min(bestEvaluation, evaluation);
+                saveBestCombination(bestCombinations, selectionSize, batchCombs[i], evaluation, bufferValues, keepsCoeffs);
+                progress.escalatedNumber += bufferValues.isEscalated;
+            }
+            batchSize = 0;
+        };
+        for (auto index = beginIndex; index < endIndex; ++index) {
+            if (index == beginIndex)
+                getCombination(index, comb);
+            else
+                nextCombination(index, comb);
+            double evaluation;
+            bufferValues.reset();
+            auto isReordered{ getDecompositionOrder(index, comb, order) };
+            const auto& decompositionOrder{ isReordered ? order : comb };
+            auto& orderedCoeffs{ workspace.orderedCoeffs };
+            auto combCoeffs = [&comb, &order, &orderedCoeffs, isReordered](VectorXd& coeffs, bool& isSolved) { 
+                if (!isReordered) // the vectors are swapped, so the memory of both of them is reused by the next models
+                    coeffs.swap(orderedCoeffs);
+                else { // rearranging the coefficients of the decomposition columns in the comb order
+                    coeffs.resize(orderedCoeffs.size());
+                    for (size_t i = 0; i < order.size(); ++i)
+                        coeffs[std::find(std::begin(comb), std::end(comb), order[i]) - std::begin(comb)] = orderedCoeffs[i];
+                }
+                isSolved = true;
+            };
+            if (isMoments && dataMoments.all.rows > 0) { // reusing the decompositions of the common columns with the previous model
+                choleskyTrain.coeffs(dataMoments.train, decompositionOrder, orderedCoeffs);
+                combCoeffs(bufferValues.coeffsTrain, bufferValues.isTrainSolved);
+                if (useCoeffsTest) {
+                    choleskyTest.coeffs(dataMoments.test, decompositionOrder, orderedCoeffs);
+                    combCoeffs(bufferValues.coeffsTest, bufferValues.isTestSolved);
+                }
+                if (useCoeffsAll) {
+                    choleskyAll.coeffs(dataMoments.all, decompositionOrder, orderedCoeffs);
+                    combCoeffs(bufferValues.coeffsAll, bufferValues.isAllSolved);
+                }
+                evaluation = criterion.calculate(dataMoments, comb, bufferValues);
+                scoreCombination(criterion, index, dataMoments, comb, bufferValues);
+            }
+            else if (isMoments) { // the models of the level have the same number of columns
+                batchCombs[batchSize] = comb;
+                batchIndexes[batchSize] = index;
+                if (!getCombinationMoments(comb, batchMoments[batchSize])) {
+                    xDataForCombination(data.xTrain, comb, workspace.xTrain);
+                    xDataForCombination(data.xTest, comb, workspace.xTest);
+                    batchMoments[batchSize].compute(workspace.xTrain, workspace.xTest, data.yTrain, data.yTest, foldsNumber);
+                }
+                if (++batchSize == BATCHSIZE)
+                    evaluateBatch();
+                continue;
+            }
+            else {
+                if (isReordered && criterion.solver == Solver::fast) { // updating the unpivoted decompositions of the parent model
+                    qrTrain.coeffs(data.xTrain, data.yTrain, order, orderedCoeffs);
+                    combCoeffs(bufferValues.coeffsTrain, bufferValues.isTrainSolved);
+                    if (useCoeffsTest) {
+                        qrTest.coeffs(data.xTest, data.yTest, order, orderedCoeffs);
+                        combCoeffs(bufferValues.coeffsTest, bufferValues.isTestSolved);
+                    }
+                    if (useCoeffsAll) {
+                        if (xAll.size() == 0) {
+                            xAll.resize(data.xTrain.rows() + data.xTest.rows(), data.xTrain.cols());
+                            xAll << data.xTrain, data.xTest;
+                            yAll.resize(data.yTrain.size() + data.yTest.size());
+                            yAll << data.yTrain, data.yTest;
+                        }
+                        qrAll.coeffs(xAll, yAll, order, orderedCoeffs);
+                        combCoeffs(bufferValues.coeffsAll, bufferValues.isAllSolved);
+                    }
+                }
+                xDataForCombination(data.xTrain, comb, workspace.xTrain);
+                xDataForCombination(data.xTest, comb, workspace.xTest);
+                evaluation = criterion.calculate(workspace.xTrain, workspace.xTest, data.yTrain, data.yTest, bufferValues);
+                scoreCombination(criterion, index, workspace.xTrain, workspace.xTest, data.yTrain, data.yTest, bufferValues);
+            }
+            bestEvaluation = std::min(bestEvaluation, evaluation);
+            saveBestCombination(bestCombinations, selectionSize, comb, evaluation, bufferValues, keepsCoeffs);
+            progress.escalatedNumber += bufferValues.isEscalated;
+        }
+        if (batchSize > 0)
+            evaluateBatch();
+        progress.publish(endIndex - beginIndex, bestEvaluation);
+    }
+}
+
+void GmdhModel::prunedPolynomialsEvaluation(const Criterion& criterion, const VectorU16& columnsOrder, ChunksScheduler& chunks,
+    uint64_t selectionSize, VectorC& bestCombinations, TaskProgress& progress) const {
+    auto n{ levelCombinationsRange.n() }, k{ levelCombinationsRange.k() };
+    VectorU16 ranks, order(k + 1), comb(k + 1), cols;
+    EvaluationWorkspace workspace;
+    BufferValues bufferValues(workspace);
+    IncrementalCholesky choleskyTrain, choleskyTest, choleskyAll; // decompositions of the previous model structure
+    std::vector<IncrementalCholesky> boundTrain(k), boundTest(k), boundAll(k); // decompositions of the subtrees columns at each depth
+    bool useCoeffsTest, useCoeffsAll, useRssTrain, useRssTest, useRssAll;
+    criterion.usedCoeffs(useCoeffsTest, useCoeffsAll);
+    criterion.usedResiduals(useRssTrain, useRssTest, useRssAll);
+    auto keepsCoeffs{ criterion.isRecalculated() };
+    auto tolerance{ BOUNDTOLERANCE * dataMoments.all.yy };
+    for (uint64_t beginIndex, endIndex; chunks.next(beginIndex, endIndex);) {
+        auto bestEvaluation{ std::numeric_limits<double>::max() };
+        levelCombinationsRange.combination(beginIndex, ranks);
+        for (auto index = beginIndex; index < endIndex;) {
+            uint64_t skippedNumber{ 0 };
+            if (selectionSize > 0 && bestCombinations.size() == selectionSize) {
+                auto depth{ k - 1 }; // the current model is the first one in the subtrees of the prefixes from this depth
+                while (depth > 0 && ranks[depth] == ranks[depth - 1] + 1)
+                    --depth;
+                for (; depth < k - 1 && skippedNumber == 0; ++depth) {
+                    auto tail{ n - 1 - ranks[depth] }; // the number of columns that can follow the prefix
+                    auto subtreeSize{ CombinationsRange::binomial(tail, k - 1 - depth) };
+                    auto colsNumber{ depth + tail + 2 };
+                    if (static_cast<double>(subtreeSize) * (k + 1) * (k + 1) < static_cast<double>(colsNumber) * colsNumber)
+                        continue; // the bound is more expensive than the evaluation of the subtree models
+                    cols.assign(1, static_cast<uint16_t>(n)); // the tail is reversed, so the next prefixes only remove its columns
+                    for (auto i = 0; i < depth; ++i)
+                        cols.push_back(columnsOrder[ranks[i]]);
+                    for (auto rank = n - 1; rank >= ranks[depth]; --rank)
+                        cols.push_back(columnsOrder[rank]);
+                    auto bound{ criterion.getLowerBound(
+                        useRssTrain ? boundTrain[depth].residualsSquare(dataMoments.train, cols) : 0,
+                        useRssTest ? boundTest[depth].residualsSquare(dataMoments.test, cols) : 0,
+                        useRssAll ? boundAll[depth].residualsSquare(dataMoments.all, cols) : 0) };
+                    if (bound > bestCombinations.front().evaluation() + tolerance)
+                        skippedNumber = std::min(subtreeSize, endIndex - index);
+                }
+            }
+            if (skippedNumber > 0) { // none of the subtree models can replace the saved ones
+                progress.prunedNumber += skippedNumber;
+                index += skippedNumber;
+                if (index < endIndex)
+                    levelCombinationsRange.combination(index, ranks);
+                continue;
+            }
+
+            for (auto i = 0; i < k; ++i)
+                order[i] = columnsOrder[ranks[i]];
+            order[k] = n;
+            comb = order;
+            std::sort(std::begin(comb), std::end(comb));
+            auto& orderedCoeffs{ workspace.orderedCoeffs };
+            auto combCoeffs = [&comb, &order, &orderedCoeffs](VectorXd& coeffs, bool& isSolved) { // rearranging coefficients in the comb order
+                coeffs.resize(orderedCoeffs.size());
+                for (size_t i = 0; i < order.size(); ++i)
+                    coeffs[std::lower_bound(std::begin(comb), std::end(comb), order[i]) - std::begin(comb)] = orderedCoeffs[i];
+                isSolved = true;
+            };
+            bufferValues.reset();
+            choleskyTrain.coeffs(dataMoments.train, order, orderedCoeffs);
+            combCoeffs(bufferValues.coeffsTrain, bufferValues.isTrainSolved);
+            if (useCoeffsTest) {
+                choleskyTest.coeffs(dataMoments.test, order, orderedCoeffs);
+                combCoeffs(bufferValues.coeffsTest, bufferValues.isTestSolved);
+            }
+            if (useCoeffsAll) {
+                choleskyAll.coeffs(dataMoments.all, order, orderedCoeffs);
+                combCoeffs(bufferValues.coeffsAll, bufferValues.isAllSolved);
+            }
+            auto evaluation{ criterion.calculate(dataMoments, comb, bufferValues) };
+            scoreCombination(criterion, index, dataMoments, comb, bufferValues);
+            bestEvaluation = std::min(bestEvaluation, evaluation);
+            saveBestCombination(bestCombinations, selectionSize, comb, evaluation, bufferValues, keepsCoeffs);
+            if (++index < endIndex)
+                levelCombinationsRange.next(ranks);
+        }
+        progress.publish(endIndex - beginIndex, bestEvaluation);
+    }
+}
+
+bool GmdhModel::usesDataRows(const Criterion& criterion) const {
+    return criterion.usesDataRows() || std::any_of(std::begin(scoredCriteria), std::end(scoredCriteria), 
+        [](CriterionType criterionType) { return Criterion::usesDataRows(criterionType); });
+}
+
+int GmdhModel::usedFolds(const Criterion& criterion) const {
+    auto foldsNumber{ criterion.usedFolds() };
+    for (auto criterionType : scoredCriteria)
+        foldsNumber = std::max(foldsNumber, Criterion::usedFolds(criterionType));
+    return foldsNumber;
+}
+
+void GmdhModel::scoreCombination(const Criterion& criterion, uint64_t index, const MatrixXd& xTrain, const MatrixXd& xTest, 
+    const VectorXd& yTrain, const VectorXd& yTest, BufferValues& bufferValues) const {
+    if (levelScores == nullptr)
+        return;
+    for (size_t i = 0; i < scoredCriteria.size(); ++i)
+        (*levelScores)(index, i) = criterion.getResult(xTrain, xTest, yTrain, yTest, scoredCriteria[i], bufferValues);
+}
+
+void GmdhModel::scoreCombination(const Criterion& criterion, uint64_t index, const SplittedMoments& moments, 
+    const VectorU16& comb, BufferValues& bufferValues) const {
+    if (levelScores == nullptr)
+        return;
+    for (size_t i = 0; i < scoredCriteria.size(); ++i)
+        (*levelScores)(index, i) = criterion.getResult(moments, comb, scoredCriteria[i], bufferValues);
+}
+
+uint64_t GmdhModel::refitCombinations(const SplittedData& data, const Criterion& criterion, VectorC& combinations) const {
+    auto tasksNumber{ static_cast<int>(std::min(static_cast<size_t>(threadsNumber), combinations.size())) };
+    std::vector<uint64_t> tasksEscalated(tasksNumber);
+    runTasks(tasksNumber, [&](int task) {
+        EvaluationWorkspace workspace;
+        BufferValues bufferValues(workspace);
+        for (auto i = static_cast<size_t>(task); i < combinations.size(); i += tasksNumber) {
+            auto& combination{ combinations[i] };
+            xDataForCombination(data.xTrain, combination.combination(), workspace.xTrain);
+            xDataForCombination(data.xTest, combination.combination(), workspace.xTest);
+            bufferValues.reset();
+            combination.setEvaluation(criterion.calculate(workspace.xTrain, workspace.xTest, data.yTrain, data.yTest, 
+                                                          bufferValues));
+            combination.setBestCoeffs(bufferValues.coeffsTrain);
+            if (criterion.isRecalculated()) // the coefficients of the screened models are replaced
+                combination.setKeptCoeffs(bufferValues.isTestSolved ? bufferValues.coeffsTest : VectorXd(), 
+                                          bufferValues.isAllSolved ? bufferValues.coeffsAll : VectorXd());
+            tasksEscalated[task] += bufferValues.isEscalated;
+        }
+    });
+    return std::accumulate(std::begin(tasksEscalated), std::end(tasksEscalated), uint64_t(0));
+}
+
+void GmdhModel::recalculateCombinations(const SplittedData& data, const Criterion& criterion, VectorC& combinations) const {
+    auto isMoments{ criterion.solver == Solver::gram && !usesDataRows(criterion) };
+    auto tasksNumber{ static_cast<int>(std::min(static_cast<size_t>(threadsNumber), combinations.size())) };
+    runTasks(tasksNumber, [&](int task) {
+        EvaluationWorkspace workspace;
+        BufferValues bufferValues(workspace);
+        SplittedMoments moments;
+        for (auto i = static_cast<size_t>(task); i < combinations.size(); i += tasksNumber) {
+            auto& combination{ combinations[i] };
+            bufferValues.coeffsTrain = combination.bestCoeffs();
+            bufferValues.coeffsTest = combination.coeffsTest();
+            bufferValues.coeffsAll = combination.coeffsAll();
+            bufferValues.isTrainSolved = true;
+            bufferValues.isTestSolved = bufferValues.coeffsTest.size() > 0;
+            bufferValues.isAllSolved = bufferValues.coeffsAll.size() > 0;
+            double evaluation;
+            if (isMoments && dataMoments.all.rows > 0)
+                evaluation = criterion.recalculate(dataMoments, combination.combination(), bufferValues);
+            else if (isMoments && getCombinationMoments(combination.combination(), moments))
+                evaluation = criterion.recalculate(moments, workspace.allCols(moments.all.xx.cols()), bufferValues);
+            else {
+                xDataForCombination(data.xTrain, combination.combination(), workspace.xTrain);
+                xDataForCombination(data.xTest, combination.combination(), workspace.xTest);
+                evaluation = criterion.recalculate(workspace.xTrain, workspace.xTest, data.yTrain, data.yTest, bufferValues);
+            }
+            combination.setEvaluation(evaluation);
+            combination.setKeptCoeffs(VectorXd(), VectorXd());
+        }
+    });
+}
+
+double GmdhModel::estimateScreeningRecall(const SplittedData& data, const SplittedData& screeningData, 
+    const Criterion& criterion, uint64_t combinationsNumber, uint64_t survivorsNumber, uint64_t selectedNumber, 
+    double screenedThreshold, double selectedThreshold) const {
+    if (survivorsNumber >= combinationsNumber)
+        return 1;
+    std::mt19937_64 generator(level);
+    std::uniform_int_distribution<uint64_t> distribution(0, combinationsNumber - 1);
+    std::vector<uint64_t> indexes(std::min(static_cast<uint64_t>(SCREENINGRECALLSAMPLE), combinationsNumber));
+    for (auto& index : indexes)
+        index = distribution(generator);
+    auto tasksNumber{ static_cast<int>(std::min(static_cast<size_t>(threadsNumber), indexes.size())) };
+    std::vector<int> tasksRejected(tasksNumber), tasksMissed(tasksNumber);
+    runTasks(tasksNumber, [&](int task) {
+        EvaluationWorkspace workspace;
+        BufferValues bufferValues(workspace);
+        VectorU16 comb;
+        auto evaluate = [&](const SplittedData& evaluationData) {
+            xDataForCombination(evaluationData.xTrain, comb, workspace.xTrain);
+            xDataForCombination(evaluationData.xTest, comb, workspace.xTest);
+            bufferValues.reset();
+            return criterion.calculate(workspace.xTrain, workspace.xTest, evaluationData.yTrain, evaluationData.yTest, 
+                                       bufferValues);
+        };
+        for (auto i = static_cast<size_t>(task); i < indexes.size(); i += tasksNumber) {
+            getCombination(indexes[i], comb);
+            if (evaluate(screeningData) > screenedThreshold) { // only the rejected models can be missed
+                ++tasksRejected[task];
+                if (evaluate(data) < selectedThreshold)
+                    ++tasksMissed[task];
+            }
+        }
+    });
+    auto rejectedNumber{ std::accumulate(std::begin(tasksRejected), std::end(tasksRejected), 0) };
+    auto missedNumber{ std::accumulate(std::begin(tasksMissed), std::end(tasksMissed), 0) };
+    if (rejectedNumber == 0)
+        return 1;
+    auto missedEstimation{ static_cast<double>(combinationsNumber - survivorsNumber) * missedNumber / rejectedNumber };
+    return selectedNumber / (selectedNumber + missedEstimation);
+}
+
+void GmdhModel::postEvaluationTask(const SplittedData& data, const Criterion& criterion, ChunksScheduler& chunks, 
+    uint64_t selectionSize, VectorC& bestCombinations, TaskProgress& progress, 
+    std::shared_ptr<boost::promise<void> > promise) const {
+    post(*threadPool, [=, &data, &criterion, &chunks, &bestCombinations, &progress]() {
+        try {
+            chunks.startSlice();
+            polynomialsEvaluation(data, criterion, chunks, selectionSize, bestCombinations, progress);
+            if (chunks.finished())
+                promise->set_value();
+            else // the tasks waiting in the queue of the thread pool get the thread
+                postEvaluationTask(data, criterion, chunks, selectionSize, bestCombinations, progress, promise);
+        }
+        catch (...) {
+            promise->set_exception(boost::current_exception());
+        }
+    });
+}
+
+void GmdhModel::saveBestCombination(VectorC& bestCombinations, uint64_t selectionSize, const VectorU16& comb, 
+    double evaluation, const BufferValues& bufferValues, bool keepsCoeffs) const {
+    const VectorXd empty;
+    const auto& coeffsTest{ bufferValues.isTestSolved ? bufferValues.coeffsTest : empty };
+    const auto& coeffsAll{ bufferValues.isAllSolved ? bufferValues.coeffsAll : empty };
+    if (bestCombinations.size() < selectionSize) { // the heap with the worst saved model on the top
+        bestCombinations.emplace_back(VectorU16(comb), VectorXd(bufferValues.coeffsTrain));
+        bestCombinations.back().setEvaluation(evaluation);
+        if (keepsCoeffs)
+            bestCombinations.back().setKeptCoeffs(coeffsTest, coeffsAll);
+        std::push_heap(std::begin(bestCombinations), std::end(bestCombinations));
+    }
+    else if (selectionSize > 0 && (evaluation < bestCombinations.front().evaluation() ||
+             (evaluation == bestCombinations.front().evaluation() &&
+              comb < bestCombinations.front().combination()))) { // replacing the worst saved model reusing its memory
+        std::pop_heap(std::begin(bestCombinations), std::end(bestCombinations));
+        auto& worstCombination{ bestCombinations.back() };
+        worstCombination.setCombination(comb);
+        worstCombination.setBestCoeffs(bufferValues.coeffsTrain);
+        worstCombination.setEvaluation(evaluation);
+        if (keepsCoeffs)
+            worstCombination.setKeptCoeffs(coeffsTest, coeffsAll);
+        std::push_heap(std::begin(bestCombinations), std::end(bestCombinations));
+    }
+}
+
+void GmdhModel::checkPruning(const Criterion& criterion) const {
+    if (criterion.solver != Solver::gram || 
+        criterion.getLowerBound(0, 0, 0) == std::numeric_limits<double>::lowest()) {
+        std::string errorMsg = "The branch-and-bound search requires " + getVariableName("Solver::gram", "Solver.GRAM") + 
+            " and the criterion based on the regularity or stability";
+        throw std::invalid_argument(errorMsg);
+    }
+}
+
+void GmdhModel::checkMomentsCriterion(const Criterion& criterion, bool withFolds) const {
+    if (criterion.solver != Solver::gram || usesDataRows(criterion) || (!withFolds && usedFolds(criterion) > 0)) {
+        std::string errorMsg = "The training without the data rows requires " + getVariableName("Solver::gram", "Solver.GRAM") + 
+            " and the criteria calculated from the moments of the training and testing data";
+        throw std::invalid_argument(errorMsg);
+    }
+}
+
+void GmdhModel::forEachChunkPart(int foldsNumber, const std::function<void(SplittedData&, bool, int)>& function) const {
+    MatrixXd x;
+    VectorXd y;
+    SplittedData part;
+    int64_t chunkBegin{ 0 }; // index of the first row of the chunk in the whole data
+    chunksReader->rewind();
+    while (chunksReader->read(x, y)) {
+        if (x.cols() != inputColsNumber || x.rows() != y.size())
+            throw std::invalid_argument("The chunks must contain " + std::to_string(inputColsNumber) + 
+                                        " columns and the target value for each row");
+        auto passRows = [&](bool isTest, int64_t begin, int64_t rows, int fold) { // the rows of the whole data
+            auto first{ std::max(begin, chunkBegin) }, last{ std::min(begin + rows, chunkBegin + x.rows()) };
+            if (first >= last)
+                return;
+            part.xTrain.resize(last - first, x.cols() + 1);
+            part.xTrain.leftCols(x.cols()) = x.middleRows(first - chunkBegin, last - first);
+            part.xTrain.col(x.cols()).setOnes();
+            part.yTrain = y.segment(first - chunkBegin, last - first);
+            part.xTest.resize(0, x.cols() + 1);
+            part.yTest.resize(0);
+            function(part, isTest, fold);
+        };
+        if (foldsNumber == 0) {
+            passRows(false, 0, chunksTrainRows, -1);
+            passRows(true, chunksTrainRows, chunksTestRows, -1);
+        }
+        else
+            forEachFoldPart(chunksTrainRows, chunksTestRows, foldsNumber, [&](bool isTest, Index begin, Index rows, int fold) {
+                passRows(isTest, (isTest ? chunksTrainRows : 0) + begin, rows, fold);
+            });
+        chunkBegin += x.rows();
     }
 }
 
@@ -73,6 +995,8 @@ bool GmdhModel::nextLevelCondition(int kBest, int pAverage, VectorC& combination
 
     decltype(auto) model = this;
     auto func = [model = model](const MatrixXd& x, const VectorU16& comb) {return model->xDataForCombination(x, comb); };
+    if (criterion.isRecalculated())
+        recalculateCombinations(data, criterion, combinations);
     auto _bestCombinations{ criterion.getBestCombinations(combinations, data, func, kBest) };
     currentLevelEvaluation = getMeanCriterionValue(_bestCombinations, pAverage);
 
@@ -87,45 +1011,124 @@ bool GmdhModel::nextLevelCondition(int kBest, int pAverage, VectorC& combination
 }
 
 GmdhModel& GmdhModel::gmdhFit(const MatrixXd& x, const VectorXd& y, const Criterion& criterion,
-            int kBest, double testSize, int pAverage, int threads, int verbose, double limit) {
+            int kBest, double testSize, int pAverage, int threads, int verbose, double limit, Executor* executor, 
+            CancellationToken* token) {
 
     if (x.rows() != y.size())
         throw std::invalid_argument(getVariableName("x", "X") + " rows number and y size must be equal");
 
+    dataMoments = SplittedMoments();
+    auto data{ internalSplitData(x, y, testSize, true) };
+
+    /*std::cout << data.xTrain << "\n\n";
+    std::cout << data.xTest << "\n\n";
+    std::cout << data.yTrain << "\n\n";
+    std::cout << data.yTest << "\n\n";*/
+    return gmdhFit(data, criterion, kBest, pAverage, threads, verbose, limit, executor, token);
+}
+
+GmdhModel& GmdhModel::gmdhFit(ChunksReader& reader, const Criterion& criterion, int kBest, double testSize, 
+            int pAverage, int threads, int verbose, double limit, Executor* executor, CancellationToken* token) {
+    checkMomentsCriterion(criterion, true);
+    int64_t rows;
+    int cols;
+    reader.getShape(rows, cols);
+    chunksTestRows = std::llround(rows * testSize); // the same split as internalSplitData() makes
+    chunksTrainRows = rows - chunksTestRows;
+    SplittedData data; // only the columns of the data are used, the moments are read from the chunks
+    data.xTrain.resize(0, cols + 1);
+    data.xTest.resize(0, cols + 1);
+    dataMoments = SplittedMoments();
+    chunksReader = &reader;
+    try {
+        gmdhFit(data, criterion, kBest, pAverage, threads, verbose, limit, executor, token);
+    }
+    catch (...) {
+        chunksReader = nullptr;
+        throw;
+    }
+    chunksReader = nullptr;
+    return *this;
+}
+
+#ifdef GMDH_MODULE
+/**
+ * @brief Check the signals of the Python interpreter reacquiring the GIL released by the fitting methods of the module
+ * 
+ * @return True if a signal handler raised an exception, e.g. KeyboardInterrupt
+ */
+bool checkPythonSignals() {
+    pybind11::gil_scoped_acquire acquire;
+    return PyErr_CheckSignals() != 0;
+}
+#endif
+
+GmdhModel& GmdhModel::gmdhFit(SplittedData& data, const Criterion& criterion, int kBest, int pAverage, int threads, 
+            int verbose, double limit, Executor* executor, CancellationToken* token) {
+
     using namespace indicators;
-    using T = boost::packaged_task<void>;
     std::unique_ptr<ProgressBar> progressBar;
 
-    boost::asio::thread_pool pool(threads); // reserving threads
-    std::vector<boost::unique_future<T::result_type> > futures; // creating vector of futures on executable tasks
+    std::unique_ptr<Executor> ownExecutor;
+    if (executor == nullptr) { // reserving threads only for this training process
+        ownExecutor = std::make_unique<Executor>(threads);
+        executor = ownExecutor.get();
+    }
+    CancellationToken ownToken;
+    if (token == nullptr)
+        token = &ownToken;
+#ifdef GMDH_MODULE
+    auto interrupted{ false };
+#endif
+    std::vector<boost::unique_future<void> > futures; // creating vector of futures on executable tasks
     futures.reserve(threads);
-    std::atomic<int> leftTasks; // TODO: change to volatile structure
+    std::vector<VectorC> tasksBestCombinations(threads); // the best models found by each task
+    struct FitCleanup { // resetting the state of the training process on any exit, including the exceptions
+        GmdhModel& model;
+        int verbose;
+        ~FitCleanup() {
+            model.threadPool = nullptr; // the own executor is destroyed after leaving the training process
+            model.levelScores = nullptr;
+            model.dataMoments = SplittedMoments();
+            if (verbose > 0)
+                indicators::show_console_cursor(true);
+        }
+    } cleanup{ *this, verbose };
+    threadPool = &executor->pool; // sharing threads with the level preparation
+    threadsNumber = threads;
+    fitReport = FitReport();
 
     level = 1; // reset last training
-    inputColsNumber = x.cols();
+    inputColsNumber = data.xTrain.cols() - 1; // the last column of the split data contains ones
     lastLevelEvaluation = std::numeric_limits<double>::max();
 
-    auto data{ internalSplitData(x, y, testSize, true) };
-
-    /*std::cout << data.xTrain << "\n\n";
-    std::cout << data.xTest << "\n\n";
-    std::cout << data.yTrain << "\n\n";
-    std::cout << data.yTest << "\n\n";*/
     bool goToTheNextLevel;
     VectorC evaluationCoeffsVec; 
     do {
+        if (level > 1 && token->isCancelled()) { // the best models of the previous level are used
+            removeExtraCombinations();
+            fitReport.truncated = true;
+            break;
+        }
         futures.clear();
         evaluationCoeffsVec.clear();
-        auto combinations{ generateCombinations(data.xTrain.cols() - 1) };
-        evaluationCoeffsVec.resize(combinations.size());
-
-        //evaluationCoeffsVec = VectorC{std::begin(combinations), std::end(combinations)}
-        auto currLevelEvaluation{ std::begin(evaluationCoeffsVec) };
-        for (auto it = std::begin(combinations); it != std::end(combinations); ++it, ++currLevelEvaluation)
-            currLevelEvaluation->setCombination(std::move(*it));
+        auto combinationsNumber{ prepareCombinations(data.xTrain.cols() - 1) };
+        auto selectionSize{ criterion.getSelectionSize(combinationsNumber, kBest) };
+        auto isMoments{ criterion.solver == Solver::gram && !usesDataRows(criterion) }; // the cost of the models doesn't depend on the rows
+        auto isScreened{ screeningFraction < 1 && !isMoments };
+        auto screeningData{ isScreened ? sampleRows(data, screeningFraction, level) : SplittedData() };
+        const auto& evaluationData{ isScreened ? screeningData : data }; // the data on which the tasks evaluate the models
+        auto evaluationSize{ isScreened ? std::min(std::max(screeningSurvivors, selectionSize), combinationsNumber) : selectionSize };
+        levelScores = nullptr;
+        if (!scoredCriteria.empty()) { // the tasks write the scores of their models to the rows of the level matrix
+            fitReport.criteriaScores.push_back(MatrixXd::Constant(combinationsNumber, scoredCriteria.size(), 
+                std::numeric_limits<double>::quiet_NaN()));
+            levelScores = &fitReport.criteriaScores.back();
+        }
+        if (isMoments)
+            prepareMoments(data, usedFolds(criterion));
 
         if (verbose > 0) {
-            leftTasks = static_cast<int>(evaluationCoeffsVec.size()); // seting up counter for verbose
             progressBar = std::make_unique<ProgressBar>(
                 option::BarWidth{ 25 },
                 option::Start{ "LEVEL " + std::to_string(level) + ((std::to_string(level).size() == 1) ? "  [" : " [")},
@@ -133,49 +1136,107 @@ GmdhModel& GmdhModel::gmdhFit(const MatrixXd& x, const VectorXd& y, const Criter
                 option::Lead{ ">" },
                 option::ShowElapsedTime{ true },
                 option::ShowPercentage{ true },
-                option::PostfixText{ "(" + std::to_string(evaluationCoeffsVec.size()) + " combinations)" }
+                option::PostfixText{ "(" + std::to_string(combinationsNumber) + " combinations)" }
             );
             show_console_cursor(false); 
             progressBar->set_progress(0);
         }
-        decltype(auto) model = this;
-        auto combsPortion{ static_cast<int>(std::ceil(evaluationCoeffsVec.size() / static_cast<double>(threads))) }; // spliting all combinations on portions for threads calculating
-        for (auto i = 0; i * combsPortion < evaluationCoeffsVec.size(); ++i) {
-            boost::packaged_task<void> pt([model = static_cast<const GmdhModel*>(model),
-                &data = static_cast<const SplittedData&>(data), &criterion = static_cast<const Criterion&>(criterion), 
-                &evaluationCoeffsVec, &leftTasks, verbose, combsPortion, i]() {
-                    model->polynomialsEvaluation(data, criterion, std::begin(evaluationCoeffsVec) + combsPortion * i,
-                        std::begin(evaluationCoeffsVec) + std::min(static_cast<size_t>(combsPortion * (i + 1)), 
-                        evaluationCoeffsVec.size()), &leftTasks, verbose); });
-            futures.push_back(pt.get_future()); // saving future on task
-            post(pool, std::move(pt)); // starting task executions
+        std::atomic<uint64_t> nextIndex{ 0 }; // the tasks take the chunks of combinations until all of them are evaluated
+        auto tasksNumber{ static_cast<int>(std::min(static_cast<uint64_t>(threads), combinationsNumber)) };
+        std::vector<ChunksScheduler> tasksChunks(tasksNumber, ChunksScheduler(nextIndex, combinationsNumber, tasksNumber, token));
+        VectorTP tasksProgress(tasksNumber);
+        auto levelStart{ std::chrono::steady_clock::now() };
+        auto levelProgress = [&]() { // summing up the progress published by the tasks
+            ProgressInfo info{ level, combinationsNumber, 0, 0, std::numeric_limits<double>::max(), false };
+            for (const auto& taskProgress : tasksProgress) {
+                info.doneCombinations += taskProgress.doneNumber.load(std::memory_order_relaxed);
+                info.bestEvaluation = std::min(info.bestEvaluation, taskProgress.bestEvaluation.load(std::memory_order_relaxed));
+            }
+            auto duration{ std::chrono::duration<double>(std::chrono::steady_clock::now() - levelStart).count() };
+            info.throughput = duration > 0 ? info.doneCombinations / duration : 0;
+            return info;
+        };
+        for (auto i = 0; i < tasksNumber; ++i) {
+            tasksBestCombinations[i].clear();
+            auto promise{ std::make_shared<boost::promise<void> >() }; // the task owns its promise until it is completed
+            futures.push_back(promise->get_future()); // saving future on task
+            postEvaluationTask(evaluationData, criterion, tasksChunks[i], evaluationSize, tasksBestCombinations[i], 
+                               tasksProgress[i], promise); // starting task executions
         } 
 
-        if (verbose > 0) {
-            while (leftTasks) {
+        if (verbose > 0 || progressCallback) {
+            auto lastCallback{ levelStart };
+            while (std::any_of(std::begin(futures), std::end(futures), [](const auto& future) { return !future.is_ready(); })) {
 #ifdef GMDH_MODULE
-                if (PyErr_CheckSignals() != 0) { // handling keyboard (ctrl+c) interruption
-                    pool.stop();
-                    pool.join();
-                    //boost::when_all(std::begin(futures), std::end(futures)).get();  
-                    return *this;
-                    //throw pybind11::error_already_set();
+                if (!interrupted && checkPythonSignals()) { // handling keyboard (ctrl+c) interruption
+                    interrupted = true;
+                    token->cancel(); // the tasks finish their current chunks and the evaluated models are used
                 }
 #endif
-                if (progressBar->current() < 100.0 * (evaluationCoeffsVec.size() - leftTasks) / evaluationCoeffsVec.size())
-                    progressBar->set_progress(100.0 * (evaluationCoeffsVec.size() - leftTasks) / evaluationCoeffsVec.size());
+                auto info{ levelProgress() };
+                if (verbose > 0 && progressBar->current() < 100.0 * info.doneCombinations / combinationsNumber)
+                    progressBar->set_progress(100.0 * info.doneCombinations / combinationsNumber);
+                if (progressCallback && 
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - lastCallback).count() >= PROGRESSPERIOD) {
+                    lastCallback = std::chrono::steady_clock::now();
+                    try {
+                        progressCallback(info);
+                    }
+                    catch (...) { // the tasks use the data of the training process, so they are stopped before leaving it
+                        nextIndex = combinationsNumber;
+                        boost::when_all(std::begin(futures), std::end(futures)).get();
+                        throw;
+                    }
+                }
                 boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
             }
-
+            futures = boost::when_all(std::begin(futures), std::end(futures)).get(); // waiting for the selection of the best models in tasks
         }
         else {
-            boost::when_all(std::begin(futures), std::end(futures)).get(); // waiting until all tasks are completed
+            futures = boost::when_all(std::begin(futures), std::end(futures)).get(); // waiting until all tasks are completed
 #ifdef GMDH_MODULE
-            if (PyErr_CheckSignals() != 0) // handling keyboard (ctrl+c) interruption
-                return *this;
+            if (!interrupted && checkPythonSignals()) { // handling keyboard (ctrl+c) interruption
+                interrupted = true;
+                token->cancel();
+            }
 #endif
         } 
+        for (auto& future : futures)
+            future.get(); // rethrowing the exceptions of the tasks
+        uint64_t prunedNumber{ 0 }, escalatedNumber{ 0 };
+        for (size_t i = 0; i < futures.size(); ++i) { // merging the best models of all tasks
+            std::move(std::begin(tasksBestCombinations[i]), std::end(tasksBestCombinations[i]), 
+                std::back_inserter(evaluationCoeffsVec));
+            prunedNumber += tasksProgress[i].prunedNumber;
+            escalatedNumber += tasksProgress[i].escalatedNumber;
+        }
+        auto info{ levelProgress() }; // the level number can be changed by the selection of the next level models
+        fitReport.evaluatedCombinations.push_back(info.doneCombinations - prunedNumber);
+        fitReport.prunedCombinations.push_back(prunedNumber);
+        if (info.doneCombinations < combinationsNumber)
+            fitReport.truncated = true;
+        selectBestCombinations(evaluationCoeffsVec, evaluationSize);
+        auto screenedThreshold{ std::numeric_limits<double>::lowest() };
+        for (const auto& combination : evaluationCoeffsVec)
+            screenedThreshold = std::max(screenedThreshold, combination.evaluation());
+        if (isScreened)
+            escalatedNumber += refitCombinations(data, criterion, evaluationCoeffsVec);
+        fitReport.escalatedCombinations.push_back(escalatedNumber);
+        auto survivorsNumber{ evaluationCoeffsVec.size() };
+        if (isScreened) // the models of the next level are selected by the values on all data rows
+            selectBestCombinations(evaluationCoeffsVec, selectionSize);
+        if (isScreened) {
+            auto selectedThreshold{ std::numeric_limits<double>::lowest() };
+            for (const auto& combination : evaluationCoeffsVec)
+                selectedThreshold = std::max(selectedThreshold, combination.evaluation());
+            fitReport.screeningRecall.push_back(estimateScreeningRecall(data, screeningData, criterion, 
+                combinationsNumber, survivorsNumber, evaluationCoeffsVec.size(), screenedThreshold, selectedThreshold));
+        }
         goToTheNextLevel = nextLevelCondition(kBest, pAverage, evaluationCoeffsVec, criterion, data, limit); // checking the results of the current level for improvement
+        if (progressCallback) {
+            info.levelCompleted = true;
+            progressCallback(info);
+        }
 
         if (verbose > 0)
         {
@@ -191,12 +1252,16 @@ GmdhModel& GmdhModel::gmdhFit(const MatrixXd& x, const VectorXd& y, const Criter
                 boost::trim_right_if(stringError, boost::is_any_of("0"));
                 boost::trim_right_if(stringError, boost::is_any_of("."));
             }
-            progressBar->set_option(option::PostfixText("(" + std::to_string(evaluationCoeffsVec.size()) + " combinations) error=" + stringError));
+            progressBar->set_option(option::PostfixText("(" + std::to_string(combinationsNumber) + " combinations) error=" + stringError));
             progressBar->set_progress(100);
         }
     } while (goToTheNextLevel);
-    if (verbose > 0)
-        show_console_cursor(true);
+#ifdef GMDH_MODULE
+    if (interrupted) { // the truncated model is valid, but the interruption is passed to Python
+        pybind11::gil_scoped_acquire acquire;
+        throw pybind11::error_already_set();
+    }
+#endif
     return *this;   
 }
 
@@ -232,9 +1297,11 @@ int GmdhModel::fromJSON(boost::json::value jsonModel) { // TODO: maybe add try/c
     return 0;
 }
 
-int validateInputData(double* testSize, int* pAverage, int* threads, int* verbose, double* limit, int* kBest) {
+int validateInputData(double* testSize, int* pAverage, int* threads, int* verbose, double* limit, int* kBest, 
+                      const Executor* executor) {
     auto errorCode{ 0 };
 #ifdef GMDH_MODULE
+    pybind11::gil_scoped_acquire acquire; // the warnings are issued from the fitting methods releasing the GIL
     auto sys = pybind11::module::import("sys");
 #else
     std::cout << DISPLAYEDCOLORWARNING;
@@ -263,9 +1330,10 @@ int validateInputData(double* testSize, int* pAverage, int* threads, int* verbos
     // block with warnings 
     if (threads)
     {
+        auto maxThreads{ executor ? executor->getThreadsNumber() : static_cast<int>(boost::thread::hardware_concurrency()) };
         if (*threads == -1)
-            *threads = boost::thread::hardware_concurrency(); // TODO: maybe find optimal count based on data.size() and hardware_concurrency()
-        else if (*threads < 1 || *threads > boost::thread::hardware_concurrency()) {
+            *threads = maxThreads; // TODO: maybe find optimal count based on data.size() and hardware_concurrency()
+        else if (*threads < 1 || *threads > maxThreads) {
             if (*threads < 1) {
 #ifdef GMDH_MODULE
                 PyErr_WarnEx(PyExc_Warning, MINTHREADSWARNING("n_jobs"), 1);
@@ -274,13 +1342,21 @@ int validateInputData(double* testSize, int* pAverage, int* threads, int* verbos
 #endif
                 *threads = 1;
             }  
-            else if (*threads > boost::thread::hardware_concurrency()) {
+            else if (executor) {
+#ifdef GMDH_MODULE
+                PyErr_WarnEx(PyExc_Warning, EXECUTORTHREADSWARNING("n_jobs"), 1);
+#else
+                std::cout << EXECUTORTHREADSWARNING("threads");
+#endif
+                *threads = maxThreads;
+            }
+            else {
 #ifdef GMDH_MODULE
                 PyErr_WarnEx(PyExc_Warning, MAXTHREADSWARNING("n_jobs"), 1);
 #else
                 std::cout << MAXTHREADSWARNING("threads");
 #endif
-                *threads = boost::thread::hardware_concurrency(); // TODO: change limit
+                *threads = maxThreads; // TODO: change limit
             }
             //errorCode |= 2;
         }
@@ -472,6 +1548,36 @@ SplittedData GmdhModel::internalSplitData(const MatrixXd& x, const VectorXd& y,
     return data;
 }
 
+SplittedData GmdhModel::sampleRows(const SplittedData& data, double fraction, int randomSeed) {
+    std::mt19937 generator(randomSeed);
+    auto sampleIndexes = [&](Index rows) { // the random rows are taken in their original order
+        std::vector<Index> indexes(rows);
+        std::iota(std::begin(indexes), std::end(indexes), 0);
+        auto sampleSize{ std::min(rows, std::max(static_cast<Index>(std::ceil(rows * fraction)), data.xTrain.cols())) };
+        std::shuffle(std::begin(indexes), std::end(indexes), generator);
+        indexes.resize(sampleSize);
+        std::sort(std::begin(indexes), std::end(indexes));
+        return indexes;
+    };
+    SplittedData sample;
+    auto trainIndexes{ sampleIndexes(data.xTrain.rows()) };
+    auto testIndexes{ sampleIndexes(data.xTest.rows()) };
+    sample.xTrain = data.xTrain(trainIndexes, Eigen::all);
+    sample.yTrain = data.yTrain(trainIndexes);
+    sample.xTest = data.xTest(testIndexes, Eigen::all);
+    sample.yTest = data.yTest(testIndexes);
+    return sample;
+}
+
+void GmdhModel::setScreening(double rowsFraction, uint64_t survivorsNumber) {
+    if (!(rowsFraction > 0 && rowsFraction <= 1)) {
+        std::string errorMsg = getVariableName("rowsFraction", "rows_fraction") + " value must be in the (0, 1] range";
+        throw std::invalid_argument(errorMsg);
+    }
+    screeningFraction = rowsFraction;
+    screeningSurvivors = survivorsNumber;
+}
+
 void GmdhModel::checkMatrixColsNumber(const MatrixXd& x) const {
     if (inputColsNumber != x.cols()) {
         std::string varName = getVariableName("x", "X");
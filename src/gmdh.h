@@ -3,6 +3,7 @@
 #define EIGEN_MPL2_ONLY
 
 #include <vector>
+#include <array>
 #include <cmath>
 #include <numeric>
 #include <cstdint>
@@ -15,10 +16,15 @@
 #include <algorithm>
 #include <atomic>
 #include <set>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
 
 #include <Eigen/Dense>
 
 #include <boost/asio.hpp>
+#include <boost/align/aligned_allocator.hpp>
 #include <boost/function.hpp>
 #include <boost/bind/bind.hpp>
 #include <boost/thread/thread.hpp>
@@ -55,6 +61,190 @@ namespace GMDH {
 SplittedData GMDH_API splitData(const MatrixXd& x, const VectorXd& y, double testSize = 0.2,
     bool shuffle = false, int randomSeed = 0);
 
+/// @brief Structure for storing the statistics of the last training process
+struct GMDH_API FitReport {
+    std::vector<uint64_t> evaluatedCombinations; //!< The number of models evaluated at each level
+    std::vector<uint64_t> prunedCombinations; //!< The number of models skipped at each level by the branch-and-bound search
+    bool truncated{ false }; //!< True if the training process was cancelled before its natural end
+    std::vector<uint64_t> escalatedCombinations; //!< The number of models at each level whose decompositions were escalated by Solver::adaptive to the pivoting ones. Each evaluated model is counted once, and the screened models trained again on all data rows are counted once more. The recalculation of the criterion and the estimation of the screening recall aren't counted
+    std::vector<MatrixXd> criteriaScores; //!< Values of the scored criteria for the models of each level. The rows correspond to the models in the order of their enumeration at the level and the columns to the criteria in the order of their setting. The rows of the models that weren't evaluated contain NaN values. It is empty if no criteria are scored
+    std::vector<double> screeningRecall; //!< Estimated fraction of the best models of each level that passed the screening on the sampled data rows. It is empty if the screening isn't used
+};
+
+/// @brief Structure of the training progress passed to the progress callback
+struct GMDH_API ProgressInfo {
+    int level; //!< The number of the current training level
+    uint64_t combinationsNumber; //!< The number of models at the level
+    uint64_t doneCombinations; //!< The number of level models evaluated or skipped by the branch-and-bound search
+    double throughput; //!< The number of level models processed per second
+    double bestEvaluation; //!< The smallest external criterion value of the level models evaluated so far
+    bool levelCompleted; //!< True if all models of the level are evaluated and the best ones are selected
+};
+
+/**
+ * @brief Function called with the training progress
+ * 
+ * It is called from the thread which started the training every PROGRESSPERIOD seconds during the level 
+ * and once after the level is completed
+ */
+using ProgressCallback = std::function<void(const ProgressInfo&)>;
+
+/**
+ * @brief Class of the thread pool that can be shared by the training processes of several models
+ * 
+ * The tasks of the training processes give their threads to the other tasks after TASKSLICEDURATION seconds, 
+ * so the concurrent training processes share the threads fairly
+ * @warning The training processes using the executor must not be started from its threads
+ */
+class GMDH_API Executor {
+    int threadsNumber; //!< The number of threads of the pool
+    boost::asio::thread_pool pool; //!< Threads executing the tasks of all training processes
+
+    friend class GmdhModel;
+public:
+    /**
+     * @brief Construct a new Executor object
+     * 
+     * @param threads The number of threads. Set -1 to use the number of concurrent threads supported by the hardware
+     * @throw std::invalid_argument if the threads value isn't a positive integer or -1
+     */
+    explicit Executor(int threads = -1);
+
+    /**
+     * @brief Get the number of threads
+     * 
+     * @return The number of threads of the pool
+     */
+    int getThreadsNumber() const { return threadsNumber; }
+
+    /// @brief Destroy the Executor object waiting for the completion of all tasks
+    ~Executor() { pool.join(); }
+};
+
+/**
+ * @brief Class of the token stopping the training processes after the deadline or on request
+ * 
+ * The tasks of the training process check the token between the chunks of the models. After the cancellation 
+ * the current level is finished with the already evaluated models and its best models are kept only 
+ * if they improve the previous level, so the model is valid and its getFitReport() result is marked as truncated
+ */
+class GMDH_API CancellationToken {
+    std::atomic<bool> cancelled; //!< True if the cancellation is requested
+    bool hasDeadline; //!< True if the token has the time limit
+    std::chrono::steady_clock::time_point deadline; //!< The time after which the token is cancelled
+public:
+    /**
+     * @brief Construct a new CancellationToken object
+     * 
+     * @param timeLimit The time in seconds from the construction after which the token is cancelled. 
+     * Set -1 to cancel the token only by the cancel() method
+     * @throw std::invalid_argument if the timeLimit value is negative and isn't -1
+     */
+    explicit CancellationToken(double timeLimit = -1);
+
+    /// @brief Request the cancellation of the training processes using the token
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether the training processes using the token should be stopped
+     * 
+     * @return True if the cancellation is requested or the deadline has passed, otherwise false
+     */
+    bool isCancelled() const {
+        return cancelled.load(std::memory_order_relaxed) || (hasDeadline && std::chrono::steady_clock::now() >= deadline);
+    }
+};
+
+/**
+ * @brief Abstract class of the source of the data rows read chunk by chunk by the out-of-core training processes
+ * 
+ * The training process reads all chunks once per pass and can make several passes, 
+ * so the source must return the same rows in the same order after each rewind() call
+ */
+class GMDH_API ChunksReader {
+public:
+    /// @brief Start the next pass from the first data row
+    virtual void rewind() = 0;
+
+    /**
+     * @brief Read the next chunk of the data rows
+     * 
+     * @param x Matrix to which the input data of the chunk rows is written
+     * @param y Vector to which the target values of the chunk rows are written
+     * @return False if all data rows have already been read, otherwise true
+     */
+    virtual bool read(MatrixXd& x, VectorXd& y) = 0;
+
+    /**
+     * @brief Get the size of the data
+     * 
+     * @param rows Variable to which the number of the data rows is written
+     * @param cols Variable to which the number of the input data columns is written
+     */
+    virtual void getShape(int64_t& rows, int& cols) = 0;
+
+    /// @brief Destroy the ChunksReader object
+    virtual ~ChunksReader() {}
+};
+
+/**
+ * @brief Class reading the chunks of the data rows from the memory-mapped binary file
+ * 
+ * The file contains the rows of 64-bit floating point numbers one by one without the header. Each row consists 
+ * of the input data values followed by the target value. Only one chunk of the file is mapped into memory at once
+ */
+class GMDH_API FileChunksReader : public ChunksReader {
+    struct FileMapping; //!< Mapping of the whole file from which the chunks are mapped. It is defined in gmdh.cpp to keep the mapping headers internal
+    std::shared_ptr<FileMapping> file; //!< Mapping of the file or nullptr if the file is empty
+    int colsNumber; //!< The number of the input data columns
+    int64_t chunkRows; //!< The maximum number of rows in the chunk
+    int64_t rowsNumber; //!< The number of rows in the file
+    int64_t nextRow; //!< Index of the first row of the next chunk
+public:
+    /**
+     * @brief Construct a new FileChunksReader object
+     * 
+     * @param path Path to the binary file
+     * @param cols The number of the input data columns
+     * @param chunkRows The maximum number of rows in the chunk
+     * @throw std::invalid_argument if the cols or chunkRows value isn't a positive integer
+     * @throw GMDH::FileException if the file can't be opened or its size isn't a multiple of the row size
+     */
+    FileChunksReader(const std::string& path, int cols, int64_t chunkRows = CHUNKROWS);
+
+    void rewind() override { nextRow = 0; }
+    bool read(MatrixXd& x, VectorXd& y) override;
+    void getShape(int64_t& rows, int& cols) override;
+};
+
+/**
+ * @brief Class reading the chunks of the data rows by the user functions
+ * 
+ * The size of the data is found by the first pass over all chunks when it is requested, unless the number of rows is given
+ */
+class GMDH_API CallbackChunksReader : public ChunksReader {
+    std::function<void()> rewindFunction; //!< Function starting the next pass from the first data row
+    std::function<bool(MatrixXd&, VectorXd&)> readFunction; //!< Function reading the next chunk
+    int64_t rowsNumber; //!< The number of the data rows or -1 if it isn't counted yet
+    int colsNumber; //!< The number of the input data columns
+public:
+    /**
+     * @brief Construct a new CallbackChunksReader object
+     * 
+     * @param rewind Function starting the next pass from the first data row
+     * @param read Function writing the next chunk of the data rows to its arguments. It returns false if all data rows 
+     * have already been read, otherwise true
+     * @param rows The number of the data rows. If it is -1, the rows are counted by a pass over all chunks, 
+     * otherwise only the first chunk is read to find the number of columns
+     */
+    CallbackChunksReader(std::function<void()> rewind, std::function<bool(MatrixXd&, VectorXd&)> read, int64_t rows = -1) 
+        : rewindFunction(std::move(rewind)), readFunction(std::move(read)), rowsNumber(rows), colsNumber(0) {}
+
+    void rewind() override { rewindFunction(); }
+    bool read(MatrixXd& x, VectorXd& y) override { return readFunction(x, y); }
+    void getShape(int64_t& rows, int& cols) override;
+};
+
 /// @brief Class implementing the general logic of GMDH algorithms
 class GMDH_API GmdhModel { 
     //int calculateLeftTasksForVerbose(const std::vector<std::shared_ptr<std::vector<Combination>::iterator> > beginTasksVec, 
@@ -66,6 +256,20 @@ protected:
     double lastLevelEvaluation; //!< The external criterion value of the previous training level
     double currentLevelEvaluation; //!< The external criterion value of the current training level
     std::vector<VectorC> bestCombinations; //!< Storage for the best models of previous levels
+    VectorVu16 levelCombinations; //!< Explicitly generated model structures of the current level
+    CombinationsRange levelCombinationsRange; //!< Lazily enumerated model structures of the current level
+    boost::asio::thread_pool* threadPool; //!< Thread pool of the current training process
+    int threadsNumber; //!< The number of threads of the current training process
+    SplittedMoments dataMoments; //!< Moments of the data used to evaluate models by Solver::gram without constructing their data
+    FitReport fitReport; //!< Statistics of the last training process
+    ProgressCallback progressCallback; //!< Function receiving the training progress
+    double screeningFraction; //!< Fraction of the data rows on which the level models are screened
+    uint64_t screeningSurvivors; //!< The number of screened models evaluated again on all data rows
+    std::vector<CriterionType> scoredCriteria; //!< Individual criteria calculated for all level models besides the selected criterion
+    MatrixXd* levelScores; //!< Matrix of the current level to which the tasks write the values of the scored criteria or nullptr if they aren't scored
+    ChunksReader* chunksReader; //!< Source of the data rows of the out-of-core training process or nullptr if the data is in memory
+    int64_t chunksTrainRows; //!< The number of the first data rows of the out-of-core training process used as the training part
+    int64_t chunksTestRows; //!< The number of the last data rows of the out-of-core training process used as the testing part
 
     /**
      * @brief Get full class name
@@ -111,17 +315,225 @@ protected:
     std::string getPolynomialCoeffValue(double coeff, bool isLastCoeff) const;
 
     /**
-     * @brief Train given subset of models and calculate external criterion for them
+     * @brief Execute tasks using the threads of the current training process and wait until all of them are completed
+     * 
+     * If there is no training process, the tasks are executed sequentially in the calling thread
+     * 
+     * @param tasksNumber The number of tasks
+     * @param task Function receiving the index of the task in the [0, tasksNumber) range
+     */
+    void runTasks(int tasksNumber, const std::function<void(int)>& task) const;
+
+    /**
+     * @brief Get the model structure of the current level by its index
+     * 
+     * @param index Index of the model structure in the range of the current level
+     * @param comb Vector to which the indexes of the data columns used in the model will be written
+     */
+    void getCombination(uint64_t index, VectorU16& comb) const;
+
+    /**
+     * @brief Replace the model structure of the current level with the following one
+     * 
+     * @param index Index of the following model structure in the range of the current level
+     * @param comb Vector containing the previous model structure
+     */
+    void nextCombination(uint64_t index, VectorU16& comb) const;
+
+    /**
+     * @brief Leave only the given number of models with the best values of the external criterion
+     * 
+     * @param combinations Vector of the trained models. The order of the remaining models isn't specified
+     * @param number The number of models that should remain
+     */
+    void selectBestCombinations(VectorC& combinations, uint64_t number) const;
+
+    /**
+     * @brief Save the evaluated model if it is one of the best ones
+     * 
+     * @param bestCombinations Bounded heap of the best models with the worst saved model on the top
+     * @param selectionSize The maximum number of the saved models
+     * @param comb Model structure
+     * @param evaluation The value of the external criterion
+     * @param bufferValues Coefficients of the model. They are copied to the saved model reusing the memory of the replaced one
+     * @param keepsCoeffs True if the coefficients calculated using testing and learning data are kept 
+     * for the recalculation of the criterion
+     */
+    void saveBestCombination(VectorC& bestCombinations, uint64_t selectionSize, const VectorU16& comb, 
+                             double evaluation, const BufferValues& bufferValues, bool keepsCoeffs) const;
+
+    /**
+     * @brief Calculate the scored criteria for the evaluated model and write them to the level score matrix
+     * 
+     * @param criterion Selected external criterion whose solver is used by the scored criteria
+     * @param index Index of the model at the level
+     * @param xTrain Input variables matrix of the training data of the model
+     * @param xTest Input variables matrix of the testing data of the model
+     * @param yTrain Target values vector of the training data
+     * @param yTest Target values vector of the testing data
+     * @param bufferValues Coefficients calculated by the selected criterion. The missing ones are calculated and saved
+     */
+    void scoreCombination(const Criterion& criterion, uint64_t index, const MatrixXd& xTrain, const MatrixXd& xTest, 
+                          const VectorXd& yTrain, const VectorXd& yTest, BufferValues& bufferValues) const;
+
+    /**
+     * @brief Calculate the scored criteria for the evaluated model using the data moments and write them to the level score matrix
+     * 
+     * @param criterion Selected external criterion whose solver is used by the scored criteria
+     * @param index Index of the model at the level
+     * @param moments Moments of the training, testing and learning data
+     * @param comb Indexes of the data columns used in the model
+     * @param bufferValues Coefficients calculated by the selected criterion. The missing ones are calculated and saved
+     */
+    void scoreCombination(const Criterion& criterion, uint64_t index, const SplittedMoments& moments, const VectorU16& comb, 
+                          BufferValues& bufferValues) const;
+
+    /**
+     * @brief Train the chunks of the level models taken by the task and calculate external criterion for them
+     * 
+     * The decompositions and the memory of the task are reused between the chunks of the models taken by the task. 
+     * With Solver::gram the models having no common data moments are collected in batches of BATCHSIZE models, 
+     * whose linear systems are solved together by batchedCholeskyCoeffs() and whose criteria being the residual sums 
+     * of squares are reduced together by batchedResidualsSquares()
      * 
      * @param data Data used for training and evaulating models
      * @param criterion Selected external criterion
-     * @param beginCoeffsVec Iterator indicating the beginning of a subset of models
-     * @param endCoeffsVec Iterator indicating the end of a subset of models
-     * @param leftTasks The number of remaining untrained models at the entire level
-     * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
+     * @param chunks Scheduler handing out the chunks of the level models to the task
+     * @param selectionSize The number of the best models of the subset that should be saved
+     * @param bestCombinations Vector to which the best models of the subset will be written.
+     * It is kept as a bounded heap during the evaluation, so the coefficients of the rejected models aren't stored
+     * @param progress Progress of the task published after each chunk
      */
-    void polynomialsEvaluation(const SplittedData& data, const Criterion& criterion, IterC beginCoeffsVec, 
-                               IterC endCoeffsVec, std::atomic<int>* leftTasks, int verbose) const;
+    virtual void polynomialsEvaluation(const SplittedData& data, const Criterion& criterion, ChunksScheduler& chunks, 
+                                       uint64_t selectionSize, VectorC& bestCombinations, TaskProgress& progress) const;
+
+    /**
+     * @brief Train the chunks of the models of the lazily enumerated range taken by the task skipping the subtrees 
+     * of the subsets that can't contain any of the best models
+     * 
+     * The combinations of the range are the ranks of the data columns in the given order, the model structures are 
+     * their sorted columns. The models are evaluated by Solver::gram. Before entering a subtree of the models 
+     * extending the common prefix, the lower bound of the criterion is calculated from the residual sums of squares 
+     * of all columns that can be used in the subtree. If the bound is greater than the worst saved model, 
+     * the whole subtree is skipped
+     * 
+     * @param criterion Selected external criterion having the lower bound
+     * @param columnsOrder Data columns in the order of their ranks. The best columns should be the first ones 
+     * to make the subtrees without them prunable
+     * @param chunks Scheduler handing out the chunks of the level models to the task
+     * @param selectionSize The number of the best models of the subset that should be saved
+     * @param bestCombinations Vector to which the best models of the subset will be written
+     * @param progress Progress of the task published after each chunk, including the number of the skipped models
+     */
+    void prunedPolynomialsEvaluation(const Criterion& criterion, const VectorU16& columnsOrder, ChunksScheduler& chunks, 
+                                     uint64_t selectionSize, VectorC& bestCombinations, TaskProgress& progress) const;
+
+    /**
+     * @brief Check whether the selected criterion or the scored criteria need the data rows
+     * 
+     * @param criterion Selected external criterion
+     * @return True if the models can't be evaluated using the data moments
+     */
+    bool usesDataRows(const Criterion& criterion) const;
+
+    /**
+     * @brief Get the number of folds of the learning data whose moments are used by the selected or the scored criteria
+     * 
+     * @param criterion Selected external criterion
+     * @return The number of folds or 0 if they aren't used
+     */
+    int usedFolds(const Criterion& criterion) const;
+
+    /**
+     * @brief Train the models again on all data rows and recalculate the external criterion for them
+     * 
+     * @param data Data used for training and evaulating models
+     * @param criterion Selected external criterion
+     * @param combinations Models screened on the sampled data rows
+     * @return The number of the models whose decompositions were escalated by Solver::adaptive
+     */
+    uint64_t refitCombinations(const SplittedData& data, const Criterion& criterion, VectorC& combinations) const;
+
+    /**
+     * @brief Recalculate the external criterion for the models remaining after the selection by the criterion.
+     * 
+     * The models are distributed between the tasks of the training process. The coefficients kept after 
+     * the evaluation of the models are reused, and the data moments of the level are used instead of the data rows 
+     * by Solver::gram
+     * 
+     * @param data Data used for training and evaulating models
+     * @param criterion Selected external criterion recalculated for the remaining models
+     * @param combinations Models remaining after the selection. Their kept coefficients are released
+     */
+    void recalculateCombinations(const SplittedData& data, const Criterion& criterion, VectorC& combinations) const;
+
+    /**
+     * @brief Estimate the fraction of the best models of the level that passed the screening on the sampled data rows
+     * 
+     * The random level models are evaluated on the sampled data rows. The models rejected by the screening are 
+     * evaluated on all data rows, and the share of them that would be selected gives the estimated number 
+     * of the missed best models among all rejected models
+     * 
+     * @param data Data used for training and evaulating models
+     * @param screeningData Sampled data rows on which the level models were screened
+     * @param criterion Selected external criterion
+     * @param combinationsNumber The number of all models of the level
+     * @param survivorsNumber The number of models that passed the screening
+     * @param selectedNumber The number of the selected best models
+     * @param screenedThreshold The worst external criterion value of the passed models on the sampled data rows
+     * @param selectedThreshold The worst external criterion value of the selected models on all data rows
+     * @return Estimated screening recall in the [0, 1] range
+     */
+    double estimateScreeningRecall(const SplittedData& data, const SplittedData& screeningData, const Criterion& criterion, 
+                                   uint64_t combinationsNumber, uint64_t survivorsNumber, uint64_t selectedNumber, 
+                                   double screenedThreshold, double selectedThreshold) const;
+
+    /**
+     * @brief Post the task evaluating the level models to the thread pool of the training process
+     * 
+     * The task evaluates the chunks for one slice and then posts itself again to the end of the pool queue, 
+     * so the tasks of other training processes sharing the pool get the thread
+     * 
+     * @param data Data used for training and evaulating models
+     * @param criterion Selected external criterion
+     * @param chunks Scheduler handing out the chunks of the level models to the task
+     * @param selectionSize The number of the best models of the subset that should be saved
+     * @param bestCombinations Vector to which the best models of the subset will be written
+     * @param progress Progress of the task published after each chunk
+     * @param promise Promise that is satisfied when all models of the level are taken and the task is completed
+     */
+    void postEvaluationTask(const SplittedData& data, const Criterion& criterion, ChunksScheduler& chunks, 
+                            uint64_t selectionSize, VectorC& bestCombinations, TaskProgress& progress, 
+                            std::shared_ptr<boost::promise<void> > promise) const;
+
+    /**
+     * @brief Check that the criterion can be used for the branch-and-bound search of the models
+     * 
+     * @param criterion Selected external criterion
+     * @throw std::invalid_argument if the criterion doesn't use Solver::gram or can't be bounded
+     */
+    void checkPruning(const Criterion& criterion) const;
+
+    /**
+     * @brief Check that the models can be evaluated only by the moments of the training and testing data
+     * 
+     * @param criterion Selected external criterion
+     * @param withFolds True if the moments of the folds can be calculated too, otherwise false
+     * @throw std::invalid_argument if the criterion doesn't use Solver::gram or needs the data rows or unavailable folds
+     */
+    void checkMomentsCriterion(const Criterion& criterion, bool withFolds = false) const;
+
+    /**
+     * @brief Read all chunks of the out-of-core training process and pass the rows of each part and fold of the data
+     * 
+     * The data consists of the training rows followed by the testing rows, the same as after internalSplitData()
+     * 
+     * @param foldsNumber The number of folds of the data whose rows are passed separately
+     * @param function Function receiving the rows with the column of ones in the xTrain and yTrain fields of its first 
+     * argument, true if they are the testing rows and the index of their fold or -1 if the folds aren't used
+     * @throw std::invalid_argument if the chunk doesn't have the same number of columns as the data
+     */
+    void forEachChunkPart(int foldsNumber, const std::function<void(SplittedData&, bool, int)>& function) const;
 
     /**
     * @brief Determine the need to continue training and prepare the algorithm for the next level
@@ -149,13 +561,61 @@ protected:
      * @param threads The number of threads used for calculations. Set -1 to use max possible threads 
      * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
      * @param limit The minimum value by which the external criterion should be improved in order to continue training
+     * @param executor Thread pool shared with other training processes. If it is nullptr, 
+     * the pool with the given number of threads is created only for this training process
+     * @param token Token stopping the training process after the deadline or on request. If the training process 
+     * is stopped, the model is built from the already evaluated models and getFitReport() result is marked as truncated
      * @throw std::invalid_argument
      * @warning If the threads or verbose value is incorrect an exception won't be thrown. 
      * Insted, the incorrect value will be replaced with the default value and a corresponding warning will be displayed
      * @return A reference to the algorithm object for which the training was performed
      */
     GmdhModel& gmdhFit(const MatrixXd& x, const VectorXd& y, const Criterion& criterion, int kBest, 
-                       double testSize, int pAverage, int threads, int verbose, double limit);
+                       double testSize, int pAverage, int threads, int verbose, double limit, Executor* executor = nullptr, 
+                       CancellationToken* token = nullptr);
+
+    /**
+     * @brief Fit the algorithm to find the best solution using the already split data
+     * 
+     * The moments of the data set in the dataMoments field before the call are used instead of the data rows, 
+     * so the split data can contain only the columns if the criterion is calculated from the moments
+     * 
+     * @param data Split data whose last column contains ones
+     * @param criterion Selected external criterion
+     * @param kBest The number of best models based of which new models of the next level will be constructed
+     * @param pAverage The number of best models based of which the external criterion for each level will be calculated
+     * @param threads The number of threads used for calculations
+     * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
+     * @param limit The minimum value by which the external criterion should be improved in order to continue training
+     * @param executor Thread pool shared with other training processes. If it is nullptr, 
+     * the pool with the given number of threads is created only for this training process
+     * @param token Token stopping the training process after the deadline or on request
+     * @return A reference to the algorithm object for which the training was performed
+     */
+    GmdhModel& gmdhFit(SplittedData& data, const Criterion& criterion, int kBest, int pAverage, int threads, 
+                       int verbose, double limit, Executor* executor, CancellationToken* token);
+
+    /**
+     * @brief Fit the algorithm to find the best solution reading the data rows chunk by chunk
+     * 
+     * The data isn't loaded into memory, its moments are accumulated by the passes over the chunks in prepareMoments(), 
+     * so the used memory is bounded by the chunk size and the size of the moments
+     * 
+     * @param reader Source of the data rows
+     * @param criterion Selected external criterion. It must use Solver::gram and be calculated from the moments
+     * @param kBest The number of best models based of which new models of the next level will be constructed
+     * @param testSize Fraction of the last data rows that should be used to evaluate models at each level
+     * @param pAverage The number of best models based of which the external criterion for each level will be calculated
+     * @param threads The number of threads used for calculations
+     * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
+     * @param limit The minimum value by which the external criterion should be improved in order to continue training
+     * @param executor Thread pool shared with other training processes
+     * @param token Token stopping the training process after the deadline or on request
+     * @throw std::invalid_argument
+     * @return A reference to the algorithm object for which the training was performed
+     */
+    GmdhModel& gmdhFit(ChunksReader& reader, const Criterion& criterion, int kBest, double testSize, int pAverage, 
+                       int threads, int verbose, double limit, Executor* executor, CancellationToken* token);
 
     /**
      * @brief Get new model structures for the new level of training
@@ -165,6 +625,52 @@ protected:
      */
     virtual VectorVu16 generateCombinations(int n_cols) const = 0;
 
+    /**
+     * @brief Prepare the range of new model structures for the new level of training
+     * 
+     * By default the model structures are generated explicitly by generateCombinations() method.
+     * Algorithms with a large number of model structures enumerate them lazily using levelCombinationsRange
+     * 
+     * @param n_cols The number of existing predictive variables at the current training level
+     * @return The number of new model structures
+     */
+    virtual uint64_t prepareCombinations(int n_cols);
+
+    /**
+     * @brief Prepare the moments of the current level data for the model evaluation by Solver::gram
+     * 
+     * By default nothing is prepared and the moments are calculated separately for the data of each model.
+     * Algorithms whose models use the data columns as is precompute dataMoments once
+     * 
+     * @param data Data used for training and evaulating models at the current level
+     * @param foldsNumber The number of folds of the learning data whose moments are used by the criterion
+     */
+    virtual void prepareMoments(const SplittedData&, int) {}
+
+    /**
+     * @brief Get the moments of the model data without constructing it
+     * 
+     * By default the moments aren't available and they are calculated from the xDataForCombination() result
+     * 
+     * @param comb Model structure
+     * @param moments Object to which the moments of the training, testing and learning data of the model will be written
+     * @return True if the moments were written, otherwise false
+     */
+    virtual bool getCombinationMoments(const VectorU16&, SplittedMoments&) const { return false; }
+
+    /**
+     * @brief Get the order of the data columns in which the decomposition of the model should be built.
+     * 
+     * The decompositions are reused between the consecutive models of the evaluation task for their common prefix of columns.
+     * Algorithms whose models extend the models of the previous level by one column place the parent columns first
+     * 
+     * @param index Index of the model structure in the range of the current level
+     * @param comb Model structure
+     * @param order Vector to which the columns order will be written if it differs from the comb order
+     * @return True if the order differs from the comb order, otherwise false
+     */
+    virtual bool getDecompositionOrder(uint64_t, const VectorU16&, VectorU16&) const { return false; }
+
     /// @brief Removed the saved models that are no longer needed
     virtual void removeExtraCombinations() = 0;
 
@@ -186,6 +692,17 @@ protected:
      */
     virtual MatrixXd xDataForCombination(const MatrixXd& x, const VectorU16& comb) const = 0;
 
+    /**
+     * @brief Write the data constructed according to the model structure from the original data to the given matrix
+     * 
+     * The memory of the matrix is reused if its size doesn't change
+     * 
+     * @param x Training data at the current level
+     * @param comb Vector containing the indexes of the x matrix columns that should be used in the model
+     * @param result Matrix for the constructed data
+     */
+    virtual void xDataForCombination(const MatrixXd& x, const VectorU16& comb, MatrixXd& result) const;
+
     /**
      * @brief Get the designation of polynomial equation
      * 
@@ -233,6 +750,16 @@ protected:
      */
     static SplittedData internalSplitData(const MatrixXd& x, const VectorXd& y, double testSize, bool addOnesCol = false);
 
+    /**
+     * @brief Get the random subset of the rows of both parts of the data keeping their order
+     * 
+     * @param data Data whose rows are sampled
+     * @param fraction Fraction of the rows of each part that should be taken
+     * @param randomSeed Seed number for the random generator to get the same rows every time
+     * @return SplittedData object containing the sampled rows. Each part keeps at least as many rows as the columns number
+     */
+    static SplittedData sampleRows(const SplittedData& data, double fraction, int randomSeed);
+
     friend SplittedData splitData(const MatrixXd& x, const VectorXd& y, double testSize,
                                            bool shuffle, int randomSeed);
 
@@ -245,7 +772,8 @@ protected:
     void checkMatrixColsNumber(const MatrixXd& x) const;
 public:
     /// @brief Construct a new Gmdh Model object
-    GmdhModel() : level(1), lastLevelEvaluation(0) {}
+    GmdhModel() : level(1), lastLevelEvaluation(0), threadPool(nullptr), threadsNumber(1), screeningFraction(1), 
+                  screeningSurvivors(0), levelScores(nullptr), chunksReader(nullptr), chunksTrainRows(0), chunksTestRows(0) {}
 
     /**
      * @brief Save model data into regular file
@@ -292,6 +820,49 @@ public:
      */
     std::string getBestPolynomial() const;
 
+    /**
+     * @brief Get the statistics of the last training process
+     * 
+     * @return FitReport object containing the statistics of each level
+     */
+    const FitReport& getFitReport() const { return fitReport; }
+
+    /**
+     * @brief Set the function receiving the progress of the next training processes
+     * 
+     * The evaluation of the models isn't slowed down by the callback, since the tasks only publish their 
+     * progress counters and the callback is called by the thread waiting for the level completion
+     * 
+     * @param callback Function called with the progress of the training. Set empty function to disable it
+     */
+    void setProgressCallback(ProgressCallback callback) { progressCallback = std::move(callback); }
+
+    /**
+     * @brief Set up the two-stage evaluation of the level models for the next training processes
+     * 
+     * All models of the level are screened on the random subset of the data rows, then the best of them are evaluated 
+     * again on all data rows and the models of the next level are selected by these values. The screening isn't used 
+     * by Solver::gram, since the cost of its models doesn't depend on the number of data rows
+     * 
+     * @param rowsFraction Fraction of the data rows used for the screening in the (0, 1] range. Set 1 to disable the screening
+     * @param survivorsNumber The number of screened models evaluated again on all data rows. 
+     * It is increased to the number of models selected at the level if it is less
+     * @throw std::invalid_argument if rowsFraction value is out of the (0, 1] range
+     */
+    void setScreening(double rowsFraction, uint64_t survivorsNumber);
+
+    /**
+     * @brief Set the individual criteria whose values are calculated for all level models by the next training processes
+     * 
+     * The scored criteria are calculated in the same pass as the selected criterion, so they reuse the data of the model 
+     * and its already calculated coefficients. The models are still selected only by the selected criterion. 
+     * The values are calculated on the data on which the models are evaluated, i.e. on the sampled rows if the screening 
+     * is set up, and are written to FitReport::criteriaScores
+     * 
+     * @param criteria Criteria types in the order of the score matrix columns. Set empty vector to disable the scoring
+     */
+    void setScoredCriteria(const std::vector<CriterionType>& criteria) { scoredCriteria = criteria; }
+
     /// @brief Destroy the GmdhModel object
     virtual ~GmdhModel() {};
 };
@@ -305,13 +876,16 @@ public:
  * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
  * @param limit The minimum value by which the external criterion should be improved in order to continue training
  * @param kBest The number of best models based of which new models of the next level will be constructed
+ * @param executor Thread pool used for calculations. If it is given, -1 threads value means all its threads 
+ * and the threads value can't be greater than the number of its threads
  * @throw std::invalid_argument if testSize, pAverage, limit or kBest value is incorrect
  * @warning If the threads or verbose value is incorrect an exception won't be thrown. 
  * Insted, the incorrect value will be replaced with the default value and a corresponding warning will be displayed
  * @return Method exit status
  */
 int GMDH_API validateInputData(double* testSize, int* pAverage = nullptr, int* threads = nullptr,
-                               int* verbose = nullptr, double* limit = nullptr, int* kBest = nullptr);
+                               int* verbose = nullptr, double* limit = nullptr, int* kBest = nullptr, 
+                               const Executor* executor = nullptr);
 
 /**
  * @brief Choose the correct variable name for the warning or exception text according to the GMDH_MODULE define
@@ -21,6 +21,7 @@ using PairMVXd = std::pair<MatrixXd, VectorXd>;
 using VectorI = std::vector<int>;
 
 class Criterion;
+class CancellationToken;
 
 /// @brief Structure for storing parts of a split dataset
 struct GMDH_API SplittedData {
@@ -30,12 +31,517 @@ struct GMDH_API SplittedData {
     VectorXd yTest; ///< The second part of the input y vector
 };
 
+/// @brief Structure for storing the sufficient statistics of the data used to train linear models
+struct GMDH_API DataMoments {
+    MatrixXd xx; ///< Gram matrix \f$ X^TX \f$ of the input matrix
+    VectorXd xy; ///< Vector \f$ X^Ty \f$ of the products of the input matrix columns and the target vector
+    double yy; ///< Squared norm \f$ y^Ty \f$ of the target vector
+    int64_t rows; ///< The number of data rows used to calculate the moments
+
+    /// @brief Construct empty DataMoments object
+    DataMoments() : yy(0), rows(0) {}
+
+    /**
+     * @brief Construct a new DataMoments object
+     * 
+     * @param x Input matrix
+     * @param y Target values vector for the corresponding x data
+     */
+    DataMoments(const MatrixXd& x, const VectorXd& y);
+
+    /**
+     * @brief Calculate the moments of the new data reusing the memory of the previous moments
+     * 
+     * @param x Input matrix
+     * @param y Target values vector for the corresponding x data
+     */
+    void compute(const Ref<const MatrixXd>& x, const Ref<const VectorXd>& y);
+
+    /**
+     * @brief Add the moments of other data rows calculating them without a temporary object
+     * 
+     * @param x Input matrix of the added rows
+     * @param y Target values vector for the corresponding x data
+     */
+    void add(const Ref<const MatrixXd>& x, const Ref<const VectorXd>& y);
+
+    /**
+     * @brief Add the moments of other data rows
+     * 
+     * @param other Moments of the data with the same columns
+     * @return A reference to the updated object
+     */
+    DataMoments& operator+=(const DataMoments& other);
+
+    /**
+     * @brief Remove the moments of the data rows included into these moments
+     * 
+     * @param other Moments of the subset of the data rows
+     * @return A reference to the updated object
+     */
+    DataMoments& operator-=(const DataMoments& other);
+
+    /**
+     * @brief Calculate the dot product \f$ (X_{comb}u)^T(X_{comb}v) \f$ of two predictions of the model
+     * 
+     * @param comb Indexes of the input matrix columns used in the model
+     * @param u The first coefficients vector
+     * @param v The second coefficients vector
+     * @return The dot product of the predicted values vectors
+     */
+    double dot(const VectorU16& comb, const VectorXd& u, const VectorXd& v) const;
+
+    /**
+     * @brief Calculate the residual sum of squares \f$ ||y-X_{comb}w||^2 \f$ of the model
+     * 
+     * @param comb Indexes of the input matrix columns used in the model
+     * @param coeffs Coefficients vector of the model
+     * @return The residual sum of squares
+     */
+    double residualsSquare(const VectorU16& comb, const VectorXd& coeffs) const;
+
+    /**
+     * @brief Get the moments of the given columns of the data rows that aren't included into the other moments
+     * 
+     * @param other Moments of the subset of the data rows
+     * @param comb Indexes of the input matrix columns
+     * @return Moments of the remaining data rows containing only the comb columns in their order
+     */
+    DataMoments difference(const DataMoments& other, const VectorU16& comb) const;
+
+    /**
+     * @brief Write the moments of the given columns of the data rows that aren't included into the other moments 
+     * to the existing object reusing its memory
+     * 
+     * @param other Moments of the subset of the data rows
+     * @param comb Indexes of the input matrix columns
+     * @param result Object to which the moments of the remaining data rows containing only the comb columns will be written
+     */
+    void difference(const DataMoments& other, const VectorU16& comb, DataMoments& result) const;
+};
+
+/// @brief Structure for storing the sufficient statistics of parts of a split dataset
+struct GMDH_API SplittedMoments {
+    DataMoments train; ///< Moments of the first part of the data
+    DataMoments test; ///< Moments of the second part of the data
+    DataMoments all; ///< Moments of the whole data
+    std::vector<DataMoments> folds; ///< Moments of the consecutive folds of the whole data used by the cross-validation
+    
+    /// @brief Construct empty SplittedMoments object
+    SplittedMoments() {}
+
+    /**
+     * @brief Construct a new SplittedMoments object
+     * 
+     * @param xTrain The first part of the input matrix
+     * @param xTest The second part of the input matrix
+     * @param yTrain The first part of the target values vector
+     * @param yTest The second part of the target values vector
+     * @param foldsNumber The number of folds whose moments are calculated in the same pass over the data
+     */
+    SplittedMoments(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest, 
+                    int foldsNumber = 0);
+
+    /**
+     * @brief Calculate the moments of the new data reusing the memory of the previous moments
+     * 
+     * @param xTrain The first part of the input matrix
+     * @param xTest The second part of the input matrix
+     * @param yTrain The first part of the target values vector
+     * @param yTest The second part of the target values vector
+     * @param foldsNumber The number of folds whose moments are calculated in the same pass over the data
+     */
+    void compute(const MatrixXd& xTrain, const MatrixXd& xTest, const VectorXd& yTrain, const VectorXd& yTest, 
+                 int foldsNumber = 0);
+};
+
+/**
+ * @brief Call the function for the parts of the data rows lying in one fold of the whole data and in one part of the split data
+ * 
+ * The whole data consists of the training rows followed by the testing rows. It is divided into consecutive folds 
+ * of almost equal sizes, so the fold containing the border of the parts is passed in two calls
+ * 
+ * @tparam Function Type of the function receiving the part of the rows
+ * @param trainRows The number of rows of the first part of the data
+ * @param testRows The number of rows of the second part of the data
+ * @param foldsNumber The number of folds
+ * @param function Function receiving true if the rows belong to the second part, the index of the first row 
+ * in this part, the number of rows and the index of the fold
+ */
+template <typename Function>
+void forEachFoldPart(Index trainRows, Index testRows, int foldsNumber, Function&& function) {
+    auto rows{ trainRows + testRows };
+    for (auto fold = 0; fold < foldsNumber; ++fold) {
+        auto begin{ rows * fold / foldsNumber };
+        auto end{ rows * (fold + 1) / foldsNumber };
+        if (begin < std::min(end, trainRows))
+            function(false, begin, std::min(end, trainRows) - begin, fold);
+        if (std::max(begin, trainRows) < end)
+            function(true, std::max(begin, trainRows) - trainRows, end - std::max(begin, trainRows), fold);
+    }
+}
+
+/**
+ * @brief Class implementing the Cholesky decomposition of the Gram matrix that is built by appending the columns one by one.
+ * 
+ * The columns that are linearly dependent on the previously appended ones aren't included into the decomposition
+ * and get zero coefficients in the solution
+ */
+class GMDH_API IncrementalCholesky {
+    MatrixXd _u; //!< Upper triangular factor \f$ U \f$ of the Gram matrix of the included columns
+    VectorXd _z; //!< Solution of the \f$ U^Tz=X^Ty \f$ system for the included columns
+    VectorU16 _cols; //!< Input matrix column indexes of all appended columns
+    std::vector<int> _included; //!< Positions of the appended columns included into the decomposition
+public:
+    /// @brief Construct empty IncrementalCholesky object
+    IncrementalCholesky() {}
+
+    /// @brief Remove all appended columns
+    void clear() { _cols.clear(); _included.clear(); }
+
+    /**
+     * @brief Append the column to the decomposition
+     * 
+     * @param moments Moments of the data
+     * @param col Index of the input matrix column
+     * @return True if the column is linearly independent on the previous columns and was included into the decomposition, otherwise false
+     */
+    bool append(const DataMoments& moments, uint16_t col);
+
+    /// @brief Remove the last appended column
+    void pop();
+
+    /**
+     * @brief Get the number of appended columns
+     * 
+     * @return The number of columns
+     */
+    int size() const { return static_cast<int>(_cols.size()); }
+
+    /**
+     * @brief Get the number of linearly independent appended columns
+     * 
+     * @return The rank of the Gram matrix
+     */
+    int rank() const { return static_cast<int>(_included.size()); }
+
+    /**
+     * @brief Calculate the least squares solution for the appended columns
+     * 
+     * @return Coefficients vector of all appended columns
+     */
+    VectorXd coeffs() const;
+
+    /**
+     * @brief Calculate the least squares solution for the appended columns writing it to the existing vector
+     * 
+     * @param result Vector to which the coefficients of all appended columns will be written
+     */
+    void coeffs(VectorXd& result) const;
+
+    /**
+     * @brief Calculate the least squares solution for the given columns reusing the decomposition of the appended columns.
+     * 
+     * The appended columns are replaced with all given columns except the last one, only the columns following 
+     * their common prefix are appended again. The last column is appended temporarily, so walking the subsets in 
+     * the depth-first (lexicographic) order costs one column append per subset
+     * 
+     * @param moments Moments of the data
+     * @param comb Indexes of the input matrix columns
+     * @return Coefficients vector of the given columns
+     */
+    VectorXd coeffs(const DataMoments& moments, const VectorU16& comb);
+
+    /**
+     * @brief Calculate the least squares solution for the given columns reusing the decomposition of the appended columns 
+     * and writing it to the existing vector
+     * 
+     * @param moments Moments of the data
+     * @param comb Indexes of the input matrix columns
+     * @param result Vector to which the coefficients of the given columns will be written
+     */
+    void coeffs(const DataMoments& moments, const VectorU16& comb, VectorXd& result);
+
+    /**
+     * @brief Calculate the residual sum of squares of the least squares solution on the data of the decomposition
+     * 
+     * @param moments Moments of the data used for appending the columns
+     * @return The residual sum of squares
+     */
+    double residualsSquare(const DataMoments& moments) const;
+
+    /**
+     * @brief Calculate the residual sum of squares of the least squares solution for the given columns 
+     * reusing the decomposition of the appended columns.
+     * 
+     * The appended columns are replaced with the given ones, only the columns following their common prefix are appended again
+     * 
+     * @param moments Moments of the data
+     * @param cols Indexes of the input matrix columns
+     * @return The residual sum of squares
+     */
+    double residualsSquare(const DataMoments& moments, const VectorU16& cols);
+
+    /**
+     * @brief Calculate the diagonal elements \f$ h_i=x_i^T(X^TX)^{-1}x_i \f$ of the hat matrix of the data rows 
+     * whose moments were used for appending the columns
+     * 
+     * @param x Input matrix of the data
+     * @return Vector of the diagonal elements for all rows of the input matrix
+     */
+    VectorXd leverages(const MatrixXd& x) const;
+};
+
+/**
+ * @brief Calculate the least squares solution for the fixed number of columns using the data moments.
+ * 
+ * The columns are processed in the same way as by IncrementalCholesky, so the solution is the same, 
+ * but the decomposition is stored on the stack and its loops are unrolled by the compiler
+ * 
+ * @tparam Width The number of columns
+ * @param moments Moments of the data
+ * @param comb Indexes of the Width data columns
+ * @return Coefficients vector of the given columns. It is stored on the stack too
+ */
+template <int Width>
+Matrix<double, Width, 1> fixedCholeskyCoeffs(const DataMoments& moments, const VectorU16& comb) {
+    Matrix<double, Width, Width> u;
+    Matrix<double, Width, 1> z;
+    int included[Width];
+    auto rank{ 0 };
+    for (auto col = 0; col < Width; ++col) {
+        auto diagonal{ moments.xx(comb[col], comb[col]) };
+        auto pivot{ diagonal };
+        for (auto i = 0; i < rank; ++i) { // solving U^T u = X^T x for the new column
+            auto value{ moments.xx(comb[included[i]], comb[col]) };
+            for (auto j = 0; j < i; ++j)
+                value -= u(j, i) * u(j, rank);
+            u(i, rank) = value / u(i, i);
+            pivot -= u(i, rank) * u(i, rank);
+        }
+        if (!(pivot > MINRELATIVEPIVOT * diagonal)) // the column is linearly dependent on the included ones
+            continue;
+        u(rank, rank) = std::sqrt(pivot);
+        auto value{ moments.xy[comb[col]] };
+        for (auto j = 0; j < rank; ++j)
+            value -= u(j, rank) * z[j];
+        z[rank] = value / u(rank, rank);
+        included[rank++] = col;
+    }
+    Matrix<double, Width, 1> result{ Matrix<double, Width, 1>::Zero() };
+    for (auto i = rank - 1; i >= 0; --i) { // solving U w = z
+        auto value{ z[i] };
+        for (auto j = i + 1; j < rank; ++j)
+            value -= u(i, j) * z[j];
+        z[i] = value / u(i, i);
+        result[included[i]] = z[i];
+    }
+    return result;
+}
+
+/**
+ * @brief Calculate the least squares solutions for the batch of models with the same number of columns using their data moments.
+ * 
+ * The moments of the models are laid out in the structure-of-arrays form, so each operation of the decomposition 
+ * is applied to all models of the batch by the SIMD instructions enabled for the compiler. The columns are processed 
+ * in the same way as by fixedCholeskyCoeffs(), but the linearly dependent columns are masked out instead of skipped, 
+ * so their rows of the factor are zero and their coefficients are zero
+ * 
+ * @tparam Width The number of columns
+ * @param moments Moments of the data of each model. All their columns are used in the models
+ * @param count The number of models in the batch, no more than BATCHSIZE
+ * @param coeffs Array to which the coefficients vectors of the models will be written
+ */
+template <int Width>
+void batchedCholeskyCoeffs(const DataMoments* const moments[], int count, VectorXd coeffs[]) {
+    using Lanes = Array<double, BATCHSIZE, 1>;
+    Lanes xx[Width][Width], xy[Width], u[Width][Width], z[Width], included[Width];
+    for (auto row = 0; row < Width; ++row) { // the unused lanes get the identity systems
+        for (auto col = row; col < Width; ++col)
+            xx[row][col].setConstant(row == col ? 1.0 : 0.0);
+        xy[row].setZero();
+    }
+    for (auto lane = 0; lane < count; ++lane) {
+        for (auto row = 0; row < Width; ++row) {
+            for (auto col = row; col < Width; ++col)
+                xx[row][col][lane] = moments[lane]->xx(row, col);
+            xy[row][lane] = moments[lane]->xy[row];
+        }
+    }
+    for (auto col = 0; col < Width; ++col) {
+        const auto& diagonal{ xx[col][col] };
+        Lanes pivot{ diagonal };
+        for (auto i = 0; i < col; ++i) { // solving U^T u = X^T x for the new column
+            Lanes value{ xx[i][col] };
+            for (auto j = 0; j < i; ++j)
+                value -= u[j][i] * u[j][col];
+            u[i][col] = (included[i] != 0).select(value / u[i][i], 0.0);
+            pivot -= u[i][col] * u[i][col];
+        }
+        included[col] = (pivot > MINRELATIVEPIVOT * diagonal).select(Lanes::Ones(), 0.0);
+        u[col][col] = (included[col] != 0).select(pivot.sqrt(), 1.0);
+        Lanes value{ xy[col] };
+        for (auto j = 0; j < col; ++j)
+            value -= u[j][col] * z[j];
+        z[col] = (included[col] != 0).select(value / u[col][col], 0.0);
+    }
+    for (auto i = Width - 1; i >= 0; --i) { // solving U w = z
+        Lanes value{ z[i] };
+        for (auto j = i + 1; j < Width; ++j)
+            value -= u[i][j] * z[j];
+        z[i] = (included[i] != 0).select(value / u[i][i], 0.0);
+    }
+    for (auto lane = 0; lane < count; ++lane) {
+        coeffs[lane].resize(Width);
+        for (auto i = 0; i < Width; ++i)
+            coeffs[lane][i] = z[i][lane];
+    }
+}
+
+/**
+ * @brief Calculate the residual sums of squares for the batch of models with the same number of columns using their data moments.
+ * 
+ * The moments and the coefficients are laid out in the same structure-of-arrays form as by batchedCholeskyCoeffs(), 
+ * and the sums are reduced in the same order as by DataMoments::residualsSquare()
+ * 
+ * @tparam Width The number of columns
+ * @param moments Moments of the data of each model. All their columns are used in the models
+ * @param count The number of models in the batch, no more than BATCHSIZE
+ * @param coeffs Coefficients vectors of the models
+ * @param rss Array to which the residual sums of squares of the models will be written
+ */
+template <int Width>
+void batchedResidualsSquares(const DataMoments* const moments[], int count, const VectorXd coeffs[], double rss[]) {
+    using Lanes = Array<double, BATCHSIZE, 1>;
+    Lanes xx[Width][Width], xy[Width], w[Width], yy{ Lanes::Zero() };
+    for (auto row = 0; row < Width; ++row) { // the unused lanes get zero values
+        for (auto col = 0; col < Width; ++col)
+            xx[row][col].setZero();
+        xy[row].setZero();
+        w[row].setZero();
+    }
+    for (auto lane = 0; lane < count; ++lane) {
+        for (auto row = 0; row < Width; ++row) {
+            for (auto col = 0; col < Width; ++col)
+                xx[row][col][lane] = moments[lane]->xx(row, col);
+            xy[row][lane] = moments[lane]->xy[row];
+            w[row][lane] = coeffs[lane][row];
+        }
+        yy[lane] = moments[lane]->yy;
+    }
+    Lanes projection{ Lanes::Zero() }, square{ Lanes::Zero() };
+    for (auto i = 0; i < Width; ++i)
+        projection += w[i] * xy[i];
+    for (auto i = 0; i < Width; ++i) {
+        Lanes row{ Lanes::Zero() };
+        for (auto j = 0; j < Width; ++j)
+            row += xx[j][i] * w[j];
+        square += w[i] * row;
+    }
+    Lanes result{ (yy - 2 * projection + square).max(0.0) }; // rounding errors can make the result negative
+    for (auto lane = 0; lane < count; ++lane)
+        rss[lane] = result[lane];
+}
+
+
+/**
+ * @brief Class implementing the Householder QR decomposition of the input matrix that is built by appending the columns one by one.
+ * 
+ * The columns that are linearly dependent on the previously appended ones aren't included into the decomposition
+ * and get zero coefficients in the solution
+ */
+class GMDH_API IncrementalQR {
+    MatrixXd _v; //!< Householder vectors of the included columns stored from the diagonal element
+    VectorXd _tau; //!< Scaling factors of the Householder reflections
+    MatrixXd _r; //!< Upper triangular factor \f$ R \f$ of the included columns
+    VectorXd _qty; //!< Target values vector transformed by all Householder reflections \f$ Q^Ty \f$
+    VectorXd _column; //!< Buffer for the transformed appended column
+    VectorU16 _cols; //!< Input matrix column indexes of all appended columns
+    std::vector<int> _included; //!< Positions of the appended columns included into the decomposition
+
+    /**
+     * @brief Apply the Householder reflection to the vector
+     * 
+     * @param index Index of the reflection
+     * @param vector Vector of the input matrix rows number
+     */
+    void reflect(int index, VectorXd& vector) const;
+public:
+    /// @brief Construct empty IncrementalQR object
+    IncrementalQR() {}
+
+    /**
+     * @brief Append the column to the decomposition
+     * 
+     * @param x Input matrix
+     * @param y Target values vector
+     * @param col Index of the input matrix column
+     * @return True if the column is linearly independent on the previous columns and was included into the decomposition, otherwise false
+     */
+    bool append(const MatrixXd& x, const VectorXd& y, uint16_t col);
+
+    /// @brief Remove the last appended column
+    void pop();
+
+    /**
+     * @brief Get the number of appended columns
+     * 
+     * @return The number of columns
+     */
+    int size() const { return static_cast<int>(_cols.size()); }
+
+    /**
+     * @brief Get the number of linearly independent appended columns
+     * 
+     * @return The rank of the decomposed matrix
+     */
+    int rank() const { return static_cast<int>(_included.size()); }
+
+    /**
+     * @brief Calculate the least squares solution for the appended columns
+     * 
+     * @return Coefficients vector of all appended columns
+     */
+    VectorXd coeffs() const;
+
+    /**
+     * @brief Calculate the least squares solution for the appended columns writing it to the existing vector
+     * 
+     * @param result Vector to which the coefficients of all appended columns will be written
+     */
+    void coeffs(VectorXd& result) const;
+
+    /**
+     * @brief Calculate the least squares solution for the given columns reusing the decomposition of the appended columns.
+     * 
+     * Works in the same way as IncrementalCholesky::coeffs(const DataMoments&, const VectorU16&)
+     * 
+     * @param x Input matrix
+     * @param y Target values vector
+     * @param comb Indexes of the input matrix columns
+     * @return Coefficients vector of the given columns
+     */
+    VectorXd coeffs(const MatrixXd& x, const VectorXd& y, const VectorU16& comb);
+
+    /**
+     * @brief Calculate the least squares solution for the given columns reusing the decomposition of the appended columns 
+     * and writing it to the existing vector
+     * 
+     * @param x Input matrix
+     * @param y Target values vector
+     * @param comb Indexes of the input matrix columns
+     * @param result Vector to which the coefficients of the given columns will be written
+     */
+    void coeffs(const MatrixXd& x, const VectorXd& y, const VectorU16& comb, VectorXd& result);
+};
 
 /// @brief Сlass representing the candidate model of the GMDH algorithm
 class GMDH_API Combination { 
     VectorU16 _combination; //!< Vector of the X matrix column indexes used to construct polynomial of the candidate model
     VectorXd _bestCoeffs; ///< Vector of the calculated coefficients corresponding to the polynomial variables of the candidate model
     double _evaluation; ///< Value of the external criterion evaluation for the candidate model
+    VectorXd _coeffsTest; ///< Coefficients vector calculated using testing data that is kept for the recalculation of the external criterion. It is empty if it isn't kept
+    VectorXd _coeffsAll; ///< Coefficients vector calculated using learning data that is kept for the recalculation of the external criterion. It is empty if it isn't kept
 public:
     /// @brief Construct a new Combination object
     Combination() {}
@@ -76,6 +582,20 @@ public:
      */
     double evaluation() const { return _evaluation; }
 
+    /**
+     * @brief Get the coefficients vector calculated using testing data and kept for the recalculation of the external criterion
+     * 
+     * @return Vector of the coefficients or empty vector if it isn't kept
+     */
+    const VectorXd& coeffsTest() const { return _coeffsTest; }
+
+    /**
+     * @brief Get the coefficients vector calculated using learning data and kept for the recalculation of the external criterion
+     * 
+     * @return Vector of the coefficients or empty vector if it isn't kept
+     */
+    const VectorXd& coeffsAll() const { return _coeffsAll; }
+
     /**
      * @brief Set the %combination vector of the X matrix column indexes used in the polynomial of the candidate model by rvalue reference
      * 
@@ -91,12 +611,21 @@ public:
     void setCombination(const VectorU16& combination) { _combination = combination; }
 
     /**
-     * @brief Set the vector of the calculated coefficients corresponding to the polynomial variables of the candidate model
+     * @brief Set the vector of the calculated coefficients corresponding to the polynomial variables of the candidate model by rvalue reference
      * 
      * @param bestCoeffs Vector of the coefficients
      */
     void setBestCoeffs(VectorXd&& bestCoeffs) { _bestCoeffs = std::move(bestCoeffs);}
 
+    /**
+     * @brief Set the vector of the calculated coefficients corresponding to the polynomial variables of the candidate model by lvalue reference.
+     * 
+     * The memory of the previous coefficients is reused if they have the same size
+     * 
+     * @param bestCoeffs Vector of the coefficients
+     */
+    void setBestCoeffs(const VectorXd& bestCoeffs) { _bestCoeffs = bestCoeffs; }
+
     /**
      * @brief Set the value of the external criterion evaluation for the candidate model
      * 
@@ -104,13 +633,42 @@ public:
      */
     void setEvaluation(double evaluation) { _evaluation = evaluation; }
 
+    /**
+     * @brief Keep the coefficients vectors calculated during the evaluation of the candidate model for the recalculation 
+     * of the external criterion
+     * 
+     * @param coeffsTest Coefficients vector calculated using testing data or empty vector
+     * @param coeffsAll Coefficients vector calculated using learning data or empty vector
+     */
+    void setKeptCoeffs(VectorXd&& coeffsTest, VectorXd&& coeffsAll) { 
+        _coeffsTest = std::move(coeffsTest); 
+        _coeffsAll = std::move(coeffsAll); 
+    }
+
+    /**
+     * @brief Keep the copies of the coefficients vectors calculated during the evaluation of the candidate model 
+     * reusing the memory of the previous ones
+     * 
+     * @param coeffsTest Coefficients vector calculated using testing data or empty vector
+     * @param coeffsAll Coefficients vector calculated using learning data or empty vector
+     */
+    void setKeptCoeffs(const VectorXd& coeffsTest, const VectorXd& coeffsAll) { 
+        _coeffsTest = coeffsTest; 
+        _coeffsAll = coeffsAll; 
+    }
+
     /**
      * @brief Overloaded comparison operator < for the two candidate models
      * 
+     * Candidate models with equal external criterion values are ordered by their column indexes
+     * so that the selection of the best models doesn't depend on the order of their evaluation
+     * 
      * @param comb Combination object of the second candidate model
      * @return True if the left candidate model has a lower external criterion value than the right candidate model, otherwise false
      */
-    bool operator<(const Combination& comb) const { return _evaluation < comb._evaluation; }
+    bool operator<(const Combination& comb) const { 
+        return _evaluation < comb._evaluation || (_evaluation == comb._evaluation && _combination < comb._combination); 
+    }
 
     /**
      * @brief Conver json object with trained model info to the Combination object
@@ -162,4 +720,162 @@ using IterC = VectorC::iterator;
 
 /// @brief A type definition for const iterator to the storage of the set of trained models
 using cIterC = VectorC::const_iterator;
+
+/// @brief Class implementing the enumeration of all combinations of k elements from n in lexicographic order without storing them
+class GMDH_API CombinationsRange {
+    int _n; //!< Number of all elements
+    int _k; //!< Number of elements in each combination
+    uint64_t _size; //!< Number of all combinations
+public:
+    /// @brief Construct an empty CombinationsRange object
+    CombinationsRange() : _n(0), _k(0), _size(0) {}
+
+    /**
+     * @brief Construct a new CombinationsRange object
+     * 
+     * @param n Number of all elements
+     * @param k Number of elements in each combination
+     * @throw std::overflow_error if the number of combinations can't be stored in a 64-bit integer
+     */
+    CombinationsRange(int n, int k);
+
+    /**
+     * @brief Get the number of all combinations
+     * 
+     * @return The number of combinations of k elements from n
+     */
+    uint64_t size() const { return _size; }
+
+    /**
+     * @brief Get the number of all elements
+     * 
+     * @return The n value
+     */
+    int n() const { return _n; }
+
+    /**
+     * @brief Get the number of elements in each combination
+     * 
+     * @return The k value
+     */
+    int k() const { return _k; }
+
+    /**
+     * @brief Get the combination by its index in lexicographic order
+     * 
+     * @param index Index of the combination in the [0, size()) range
+     * @param comb Vector to which the combination will be written. The n value is added as the last element 
+     * to use the column of ones in the model
+     */
+    void combination(uint64_t index, VectorU16& comb) const;
+
+    /**
+     * @brief Replace the combination with the next one in lexicographic order
+     * 
+     * @param comb Vector containing the combination obtained by combination() or next() methods
+     */
+    void next(VectorU16& comb) const;
+
+    /**
+     * @brief Calculate the binomial coefficient
+     * 
+     * @param n Number of all elements
+     * @param k Number of required elements
+     * @throw std::overflow_error if the result can't be stored in a 64-bit integer
+     * @return The number of combinations of k elements from n
+     */
+    static uint64_t binomial(int n, int k);
+};
+
+/**
+ * @brief Class handing out the chunks of the level models to one task from the cursor shared by all tasks of the level
+ * 
+ * The size of the next chunk is estimated from the time of the previous one, so each chunk takes about CHUNKDURATION 
+ * seconds. The size is also limited by the share of the remaining models, so the tasks finish together 
+ * even if some threads are slower than others. The chunks are taken in slices of TASKSLICEDURATION seconds, 
+ * between which the task can give its thread to the other tasks. After the training process is cancelled 
+ * the task takes only its first chunk of the level, so each level has at least one evaluated model
+ */
+class GMDH_API ChunksScheduler {
+    std::atomic<uint64_t>* _nextIndex; //!< Index of the first model that isn't taken by any task
+    uint64_t _size; //!< The number of models at the level
+    uint64_t _tasksNumber; //!< The number of tasks sharing the models
+    uint64_t _chunkSize; //!< The size of the next chunk
+    uint64_t _lastSize; //!< The size of the previous chunk
+    std::chrono::steady_clock::time_point _lastStart; //!< The time when the previous chunk was taken
+    std::chrono::steady_clock::time_point _sliceStart; //!< The time when the current slice was started
+    bool _finished; //!< True if all models of the level are taken
+    bool _started; //!< True if the task has taken a chunk of the level
+    const CancellationToken* _token; //!< Token stopping the handing out of the chunks
+public:
+    /**
+     * @brief Construct a new ChunksScheduler object
+     * 
+     * @param nextIndex Cursor shared by all tasks of the level. It should be set to 0 before the tasks start
+     * @param size The number of models at the level
+     * @param tasksNumber The number of tasks sharing the models
+     * @param token Token of the training process. If it is nullptr, the chunks are handed out until all models are taken
+     */
+    ChunksScheduler(std::atomic<uint64_t>& nextIndex, uint64_t size, int tasksNumber, 
+        const CancellationToken* token = nullptr) : _nextIndex(&nextIndex), _size(size), 
+        _tasksNumber(static_cast<uint64_t>(std::max(tasksNumber, 1))), _chunkSize(1), _lastSize(0), 
+        _sliceStart(std::chrono::steady_clock::now()), _finished(false), _started(false), _token(token) {}
+
+    /**
+     * @brief Get the number of models at the level
+     * 
+     * @return The number of models of all tasks
+     */
+    uint64_t size() const { return _size; }
+
+    /**
+     * @brief Check whether all models of the level are taken
+     * 
+     * @return True if the task has nothing to evaluate, false if only the current slice is finished
+     */
+    bool finished() const { return _finished; }
+
+    /// @brief Start the new slice of the chunks after the task has waited for its thread
+    void startSlice();
+
+    /**
+     * @brief Take the next chunk of the models
+     * 
+     * The previous chunk is considered to be evaluated, so the time since the previous call is used to size the next chunk
+     * 
+     * @param beginIndex Index of the first model of the chunk
+     * @param endIndex Index following the last model of the chunk
+     * @return True if the chunk is taken, false if all models of the level are already taken, the training process 
+     * is cancelled or the slice is finished
+     */
+    bool next(uint64_t& beginIndex, uint64_t& endIndex);
+};
+
+/**
+ * @brief Structure of the progress of the task evaluating the level models
+ * 
+ * Each object is written only by its task and is aligned to the cache line size, so the tasks don't share 
+ * the written memory. The values are published once per chunk and summed up only when the progress is displayed
+ */
+struct GMDH_API alignas(CACHELINESIZE) TaskProgress {
+    std::atomic<uint64_t> doneNumber{ 0 }; //!< The number of the level models evaluated or skipped by the task
+    std::atomic<double> bestEvaluation{ std::numeric_limits<double>::max() }; //!< The smallest criterion value found by the task
+    uint64_t prunedNumber{ 0 }; //!< The number of the level models skipped by the task without the evaluation. It is read after the task is completed
+    uint64_t escalatedNumber{ 0 }; //!< The number of the level models whose decompositions were escalated by Solver::adaptive. It is read after the task is completed
+
+    /**
+     * @brief Publish the results of the chunk evaluated by the task
+     * 
+     * @param number The number of the models of the chunk
+     * @param evaluation The smallest criterion value of the chunk models
+     */
+    void publish(uint64_t number, double evaluation) {
+        doneNumber.store(doneNumber.load(std::memory_order_relaxed) + number, std::memory_order_relaxed);
+        if (evaluation < bestEvaluation.load(std::memory_order_relaxed))
+            bestEvaluation.store(evaluation, std::memory_order_relaxed);
+    }
+};
+
+/// @brief A type definition for storing the progress of the tasks, whose allocator respects the cache line alignment
+using VectorTP = std::vector<TaskProgress, boost::alignment::aligned_allocator<TaskProgress, CACHELINESIZE> >;
 };
\ No newline at end of file
@@ -11,10 +11,93 @@ bool LinearModel::preparations(SplittedData& data, VectorC&& _bestCombinations)
     return level + 1 < data.xTrain.cols();
 }
 
+void LinearModel::prepareMoments(const SplittedData& data, int foldsNumber) {
+    if (dataMoments.all.rows > 0) // the data doesn't change between levels
+        return;
+    if (chunksReader == nullptr) {
+        dataMoments = SplittedMoments(data.xTrain, data.xTest, data.yTrain, data.yTest, foldsNumber);
+        return;
+    }
+    dataMoments.folds.resize(foldsNumber);
+    forEachChunkPart(foldsNumber, [this](SplittedData& part, bool isTest, int fold) {
+        DataMoments moments(part.xTrain, part.yTrain);
+        (isTest ? dataMoments.test : dataMoments.train) += moments;
+        if (fold >= 0)
+            dataMoments.folds[fold] += moments;
+    });
+    dataMoments.all = dataMoments.train;
+    dataMoments.all += dataMoments.test;
+}
+
+bool LinearModel::isTestRow(int64_t row, double testSize) {
+    return std::floor((row + 1) * testSize) > std::floor(row * testSize);
+}
+
+SplittedMoments LinearModel::rowsMoments(const MatrixXd& x, const VectorXd& y, int64_t firstRow, double testSize) {
+    std::vector<Index> trainRows, testRows;
+    for (Index i = 0; i < x.rows(); ++i)
+        (isTestRow(firstRow + i, testSize) ? testRows : trainRows).push_back(i);
+    auto withOnes = [&x](const std::vector<Index>& rows) {
+        MatrixXd result(rows.size(), x.cols() + 1);
+        result.leftCols(x.cols()) = x(rows, Eigen::all);
+        result.col(x.cols()).setOnes();
+        return result;
+    };
+    return SplittedMoments(withOnes(trainRows), withOnes(testRows), y(trainRows), y(testRows));
+}
+
+GmdhModel& LinearModel::partialGmdhFit(const MatrixXd& x, const VectorXd& y, const MatrixXd& expiredX, 
+    const VectorXd& expiredY, const Criterion& criterion, int kBest, double testSize, int pAverage, int threads, 
+    int verbose, double limit, Executor* executor, CancellationToken* token) {
+    checkMomentsCriterion(criterion);
+    if (x.rows() != y.size())
+        throw std::invalid_argument(getVariableName("x", "X") + " rows number and y size must be equal");
+    if (expiredX.rows() != expiredY.size())
+        throw std::invalid_argument(getVariableName("expiredX", "expired_X") + " rows number and " + 
+            getVariableName("expiredY", "expired_y") + " size must be equal");
+    auto isStarted{ appendedRowsNumber > 0 };
+    auto colsNumber{ isStarted ? partialMoments.all.xx.cols() - 1 : x.cols() };
+    if (x.cols() != colsNumber || (expiredX.rows() > 0 && expiredX.cols() != colsNumber))
+        throw std::invalid_argument("The data rows must have " + std::to_string(colsNumber) + " columns");
+    if (isStarted && testSize != partialTestSize)
+        throw std::invalid_argument(getVariableName("testSize", "test_size") + 
+            " value must be the same for all partial training processes");
+    if (expiredX.rows() > appendedRowsNumber - expiredRowsNumber + x.rows())
+        throw std::invalid_argument("The number of expired rows can't be greater than the number of appended rows");
+
+    auto moments{ partialMoments };
+    auto appended{ rowsMoments(x, y, appendedRowsNumber, testSize) };
+    moments.train += appended.train;
+    moments.test += appended.test;
+    if (expiredX.rows() > 0) {
+        auto expired{ rowsMoments(expiredX, expiredY, expiredRowsNumber, testSize) };
+        moments.train -= expired.train;
+        moments.test -= expired.test;
+    }
+    if (moments.train.rows == 0 || moments.test.rows == 0)
+        throw std::invalid_argument("The training and testing parts of the remaining data rows can't be empty");
+    moments.all = moments.train;
+    moments.all += moments.test;
+
+    partialMoments = std::move(moments);
+    appendedRowsNumber += x.rows();
+    expiredRowsNumber += expiredX.rows();
+    partialTestSize = testSize;
+    dataMoments = partialMoments; // the levels are evaluated by the moments without the data rows
+    SplittedData data;
+    data.xTrain.resize(0, colsNumber + 1);
+    data.xTest.resize(0, colsNumber + 1);
+    return gmdhFit(data, criterion, kBest, pAverage, threads, verbose, limit, executor, token);
+}
+
 MatrixXd LinearModel::xDataForCombination(const MatrixXd& x, const VectorU16& comb) const {
     return x(Eigen::all, comb);
 } // LCOV_EXCL_LINE
 
+void LinearModel::xDataForCombination(const MatrixXd& x, const VectorU16& comb, MatrixXd& result) const {
+    result = x(Eigen::all, comb);
+}
+
 std::string LinearModel::getPolynomialPrefix(int levelIndex, int combIndex) const {
     return "y =";
 }
@@ -23,7 +106,7 @@ std::string LinearModel::getPolynomialVariable(int levelIndex, int coeffIndex, i
     return ((coeffIndex != coeffsNumber - 1) ? "x" + std::to_string(bestColsIndexes[coeffIndex] + 1) : "");
 } // LCOV_EXCL_LINE
 
-LinearModel::LinearModel() {
+LinearModel::LinearModel() : appendedRowsNumber(0), expiredRowsNumber(0), partialTestSize(0) {
     bestCombinations.resize(1);
 }
 
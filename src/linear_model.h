@@ -5,16 +5,73 @@ namespace GMDH {
 
 /// @brief Class implementing the general logic of GMDH linear algorithms
 class GMDH_API LinearModel : public GmdhModel {
+    SplittedMoments partialMoments; //!< Moments of the training and testing data rows accumulated by the partial training processes
+    int64_t appendedRowsNumber; //!< The number of data rows appended by the partial training processes
+    int64_t expiredRowsNumber; //!< The number of the oldest appended data rows removed by the partial training processes
+    double partialTestSize; //!< Fraction of the appended data rows included into the testing part
+
+    /**
+     * @brief Check if the appended data row is included into the testing part
+     * 
+     * The testing rows are spread evenly over the appended rows, so any window of the consecutive rows 
+     * is split in the given proportion and the part of the removed row is known from its number
+     * 
+     * @param row Number of the data row since the first partial training process
+     * @param testSize Fraction of the data rows included into the testing part
+     * @return True if the row is included into the testing part, otherwise false
+     */
+    static bool isTestRow(int64_t row, double testSize);
+
+    /**
+     * @brief Calculate the moments of the training and testing parts of the consecutive appended data rows
+     * 
+     * @param x Matrix of input data rows
+     * @param y Vector of the target values for the corresponding x data
+     * @param firstRow Number of the first row since the first partial training process
+     * @param testSize Fraction of the data rows included into the testing part
+     * @return Moments of the training and testing parts of the rows
+     */
+    static SplittedMoments rowsMoments(const MatrixXd& x, const VectorXd& y, int64_t firstRow, double testSize);
 protected:
     virtual void removeExtraCombinations() override;
     virtual bool preparations(SplittedData& data, VectorC&& _bestCombinations) override;
     virtual MatrixXd xDataForCombination(const MatrixXd& x, const VectorU16& comb) const override;
+    virtual void xDataForCombination(const MatrixXd& x, const VectorU16& comb, MatrixXd& result) const override;
+    virtual void prepareMoments(const SplittedData& data, int foldsNumber) override;
 
     std::string getPolynomialPrefix(int levelIndex, int combIndex) const override;
     std::string getPolynomialVariable(int levelIndex, int coeffIndex, int coeffsNumber, 
                                         const VectorU16& bestColsIndexes) const override;
 
     virtual VectorVu16 generateCombinations(int n_cols) const override = 0;
+
+    /**
+     * @brief Update the accumulated moments by the new and expired data rows and fit the algorithm using them
+     * 
+     * The new rows are appended after all previous ones and the expired rows are removed starting from the oldest one, 
+     * so the cost of the update depends only on the number of these rows. The models of all levels are searched again 
+     * using the updated moments without the previous data rows
+     * 
+     * @param x Matrix of the new input data rows
+     * @param y Vector of the target values for the corresponding x data
+     * @param expiredX Matrix of the oldest previously appended data rows that must be removed, in their original order
+     * @param expiredY Vector of the target values for the corresponding expiredX data
+     * @param criterion Selected external criterion. It must use Solver::gram and be calculated from the moments 
+     * of the training and testing data
+     * @param kBest The number of best models based of which new models of the next level will be constructed
+     * @param testSize Fraction of the data rows included into the testing part. It must be the same for all calls
+     * @param pAverage The number of best models based of which the external criterion for each level will be calculated
+     * @param threads The number of threads used for calculations
+     * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
+     * @param limit The minimum value by which the external criterion should be improved in order to continue training
+     * @param executor Thread pool shared with other training processes
+     * @param token Token stopping the training process after the deadline or on request
+     * @throw std::invalid_argument
+     * @return A reference to the algorithm object for which the training was performed
+     */
+    GmdhModel& partialGmdhFit(const MatrixXd& x, const VectorXd& y, const MatrixXd& expiredX, const VectorXd& expiredY, 
+                              const Criterion& criterion, int kBest, double testSize, int pAverage, int threads, 
+                              int verbose, double limit, Executor* executor, CancellationToken* token);
 public:
     /// @brief Construct a new LinearModel object
     LinearModel();
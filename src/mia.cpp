@@ -6,21 +6,162 @@ VectorVu16 MIA::generateCombinations(int n_cols) const {
 	return nChooseK(n_cols, 2);
 }
 
+uint64_t MIA::prepareCombinations(int n_cols) {
+	levelCombinations.clear();
+	levelCombinationsRange = CombinationsRange(n_cols, 2);
+	return levelCombinationsRange.size();
+}
+
+PolynomialMoments::PolynomialMoments(const MatrixXd& x, const VectorXd& y, PolynomialType polynomialType) 
+    : y(y.sum()), yy(y.squaredNorm()), rows(x.rows()) {
+    auto isQuadratic{ polynomialType == PolynomialType::quadratic };
+    MatrixXd x2{ x.cwiseAbs2() };
+    x1x1.noalias() = x.transpose() * x;
+    xSums.resize(isQuadratic ? 4 : 2, x.cols());
+    xSums.row(0) = x.colwise().sum();
+    xSums.row(1) = x2.colwise().sum();
+    ySums.resize(isQuadratic ? 2 : 1, x.cols());
+    ySums.row(0).noalias() = y.transpose() * x;
+    if (polynomialType != PolynomialType::linear) { // the product of the columns is used
+        x2x1.noalias() = x2.transpose() * x;
+        x2x2.noalias() = x2.transpose() * x2;
+        yx1x1.noalias() = x.transpose() * (y.asDiagonal() * x);
+    }
+    if (isQuadratic) {
+        MatrixXd x3{ x2.cwiseProduct(x) };
+        x3x1.noalias() = x3.transpose() * x;
+        xSums.row(2) = x3.colwise().sum();
+        xSums.row(3) = x2.cwiseAbs2().colwise().sum();
+        ySums.row(1).noalias() = y.transpose() * x2;
+    }
+}
+
+PolynomialMoments& PolynomialMoments::operator+=(const PolynomialMoments& other) {
+    if (rows == 0)
+        return *this = other;
+    x1x1 += other.x1x1;
+    x2x1 += other.x2x1;
+    x3x1 += other.x3x1;
+    x2x2 += other.x2x2;
+    yx1x1 += other.yx1x1;
+    xSums += other.xSums;
+    ySums += other.ySums;
+    y += other.y;
+    yy += other.yy;
+    rows += other.rows;
+    return *this;
+}
+
+double PolynomialMoments::sum(uint16_t i, uint16_t j, int a, int b) const {
+    if (b == 0)
+        return a == 0 ? static_cast<double>(rows) : xSums(a - 1, i);
+    if (a == 0)
+        return xSums(b - 1, j);
+    if (a < b) { // the sums matrices contain the greater power of the first column
+        std::swap(i, j);
+        std::swap(a, b);
+    }
+    if (b == 2)
+        return x2x2(i, j);
+    return a == 1 ? x1x1(i, j) : (a == 2 ? x2x1(i, j) : x3x1(i, j));
+}
+
+double PolynomialMoments::ySum(uint16_t i, uint16_t j, int a, int b) const {
+    if (b == 0)
+        return a == 0 ? y : ySums(a - 1, i);
+    if (a == 0)
+        return ySums(b - 1, j);
+    return yx1x1(i, j);
+}
+
+DataMoments PolynomialMoments::pairMoments(uint16_t i, uint16_t j, PolynomialType polynomialType) const {
+    DataMoments moments;
+    pairMoments(i, j, polynomialType, moments);
+    return moments;
+}
+
+void PolynomialMoments::pairMoments(uint16_t i, uint16_t j, PolynomialType polynomialType, DataMoments& moments) const {
+    using Powers = std::vector<std::pair<int, int> >; // powers of the pair columns in each variable of the polynomial
+    static const Powers linearPowers{ {1, 0}, {0, 1}, {0, 0} };
+    static const Powers linearCovPowers{ {1, 0}, {0, 1}, {1, 1}, {0, 0} };
+    static const Powers quadraticPowers{ {1, 0}, {0, 1}, {1, 1}, {2, 0}, {0, 2}, {0, 0} };
+    const auto& powers{ polynomialType == PolynomialType::linear ? linearPowers : 
+                        (polynomialType == PolynomialType::linear_cov ? linearCovPowers : quadraticPowers) };
+    auto size{ static_cast<int>(powers.size()) };
+    moments.xx.resize(size, size);
+    moments.xy.resize(size);
+    for (auto row = 0; row < size; ++row) {
+        for (auto col = 0; col <= row; ++col)
+            moments.xx(row, col) = moments.xx(col, row) = sum(i, j, powers[row].first + powers[col].first, 
+                                                               powers[row].second + powers[col].second);
+        moments.xy[row] = ySum(i, j, powers[row].first, powers[row].second);
+    }
+    moments.yy = yy;
+    moments.rows = rows;
+}
+
 MatrixXd MIA::getPolynomialX(const MatrixXd& x) const {
-    MatrixXd polyX(x);
+    MatrixXd polyX;
+    getPolynomialX(x, VectorU16{ 0, 1, 2 }, polyX);
+    return polyX;
+}
+
+void MIA::getPolynomialX(const MatrixXd& x, const VectorU16& comb, MatrixXd& polyX) const {
     if ((polynomialType == PolynomialType::linear_cov)) {
-        polyX.conservativeResize(NoChange, 4);
-        polyX.col(2) = x.col(0).cwiseProduct(x.col(1));
-        polyX.col(3) = x.col(2);
+        polyX.resize(x.rows(), 4);
+        polyX.col(2) = x.col(comb[0]).cwiseProduct(x.col(comb[1]));
     }
     else if ((polynomialType == PolynomialType::quadratic)) {
-        polyX.conservativeResize(NoChange, 6);
-        polyX.col(2) = x.col(0).cwiseProduct(x.col(1));
-        polyX.col(3) = x.col(0).cwiseProduct(x.col(0));
-        polyX.col(4) = x.col(1).cwiseProduct(x.col(1));
-        polyX.col(5) = x.col(2);
+        polyX.resize(x.rows(), 6);
+        polyX.col(2) = x.col(comb[0]).cwiseProduct(x.col(comb[1]));
+        polyX.col(3) = x.col(comb[0]).cwiseProduct(x.col(comb[0]));
+        polyX.col(4) = x.col(comb[1]).cwiseProduct(x.col(comb[1]));
     }
-    return polyX;
+    else
+        polyX.resize(x.rows(), 3);
+    polyX.col(0) = x.col(comb[0]);
+    polyX.col(1) = x.col(comb[1]);
+    polyX.col(polyX.cols() - 1) = x.col(comb[2]);
+}
+
+void MIA::prepareMoments(const SplittedData& data, int foldsNumber) {
+    auto cols{ data.xTrain.cols() - 1 }; // the column of ones is added to each polynomial
+    levelMoments.assign(3 + foldsNumber, PolynomialMoments());
+    if (chunksReader != nullptr) {
+        forEachChunkPart(foldsNumber, [this, cols](SplittedData& part, bool isTest, int fold) {
+            for (auto i = 0; i < level - 1; ++i) // the chunk columns are built by the best models of the previous levels
+                transformDataForNextLevel(part, bestCombinations[i]);
+            PolynomialMoments moments(part.xTrain.leftCols(cols), part.yTrain, polynomialType);
+            levelMoments[isTest ? 1 : 0] += moments;
+            if (fold >= 0)
+                levelMoments[3 + fold] += moments;
+        });
+    }
+    else if (foldsNumber == 0) {
+        levelMoments[0] = PolynomialMoments(data.xTrain.leftCols(cols), data.yTrain, polynomialType);
+        levelMoments[1] = PolynomialMoments(data.xTest.leftCols(cols), data.yTest, polynomialType);
+    }
+    forEachFoldPart(data.xTrain.rows(), data.xTest.rows(), foldsNumber, [&](bool isTest, Index begin, Index rows, int fold) {
+        const auto& x{ isTest ? data.xTest : data.xTrain };
+        const auto& y{ isTest ? data.yTest : data.yTrain };
+        PolynomialMoments part(x.block(begin, 0, rows, cols), y.segment(begin, rows), polynomialType);
+        levelMoments[isTest ? 1 : 0] += part;
+        levelMoments[3 + fold] += part;
+    });
+    levelMoments[2] = levelMoments[0];
+    levelMoments[2] += levelMoments[1];
+}
+
+bool MIA::getCombinationMoments(const VectorU16& comb, SplittedMoments& moments) const {
+    if (levelMoments.empty())
+        return false;
+    levelMoments[0].pairMoments(comb[0], comb[1], polynomialType, moments.train);
+    levelMoments[1].pairMoments(comb[0], comb[1], polynomialType, moments.test);
+    levelMoments[2].pairMoments(comb[0], comb[1], polynomialType, moments.all);
+    moments.folds.resize(levelMoments.size() - 3);
+    for (size_t fold = 0; fold < moments.folds.size(); ++fold)
+        levelMoments[3 + fold].pairMoments(comb[0], comb[1], polynomialType, moments.folds[fold]);
+    return true;
 }
 
 void MIA::transformDataForNextLevel(SplittedData& data, const VectorC& bestCombinations) {
@@ -70,6 +211,10 @@ MatrixXd MIA::xDataForCombination(const MatrixXd& x, const VectorU16& comb) cons
     return getPolynomialX(x(Eigen::all, comb));
 } // LCOV_EXCL_LINE
 
+void MIA::xDataForCombination(const MatrixXd& x, const VectorU16& comb, MatrixXd& result) const {
+    getPolynomialX(x, comb, result);
+}
+
 std::string MIA::getPolynomialPrefix(int levelIndex, int combIndex) const {
     return ((levelIndex < bestCombinations.size() - 1) ?
         "f" + std::to_string(levelIndex + 1) + "_" + std::to_string(combIndex + 1) : "y") + " =";
@@ -127,9 +272,7 @@ int MIA::fromJSON(boost::json::value jsonModel) {
     return 0;
 }
 
-GmdhModel& MIA::fit(const MatrixXd& x, const VectorXd& y, const Criterion& criterion, int kBest, 
-                    PolynomialType _polynomialType, double testSize, int pAverage, 
-                    int threads, int verbose, double limit) {
+void MIA::checkLevelsParameters(int kBest, Index cols) const {
     /*
     It is necessasy for kBest value to be >= 3 for the MIA algorithm because 
     the number of combinations at each level is equal to combinations of 2 elements from kBest.
@@ -146,14 +289,37 @@ GmdhModel& MIA::fit(const MatrixXd& x, const VectorXd& y, const Criterion& crite
     if columns < 3 then the number of combinations won't be enough
     to move to the next levels.
     */
-    if (x.cols() < 3) {
+    if (cols < 3) {
         std::string errorMsg = getVariableName("x", "X") + " columns must be >= 3";
         throw std::invalid_argument(errorMsg);
     }
+}
+
+GmdhModel& MIA::fit(const MatrixXd& x, const VectorXd& y, const Criterion& criterion, int kBest, 
+                    PolynomialType _polynomialType, double testSize, int pAverage, 
+                    int threads, int verbose, double limit, Executor* executor, 
+                    CancellationToken* token) {
+    checkLevelsParameters(kBest, x.cols());
+    validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, &kBest, executor);
+    polynomialType = _polynomialType;
+    GmdhModel::gmdhFit(x, y, criterion, kBest, testSize, pAverage, threads, verbose, limit, executor, token);
+    levelMoments.clear();
+    return *this;
+}
 
-    validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, &kBest);
+GmdhModel& MIA::fitChunks(ChunksReader& reader, const Criterion& criterion, int kBest, 
+                          PolynomialType _polynomialType, double testSize, int pAverage, 
+                          int threads, int verbose, double limit, Executor* executor, 
+                          CancellationToken* token) {
+    int64_t rows;
+    int cols;
+    reader.getShape(rows, cols);
+    checkLevelsParameters(kBest, cols);
+    validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, &kBest, executor);
     polynomialType = _polynomialType;
-    return GmdhModel::gmdhFit(x, y, criterion, kBest, testSize, pAverage, threads, verbose, limit);
+    GmdhModel::gmdhFit(reader, criterion, kBest, testSize, pAverage, threads, verbose, limit, executor, token);
+    levelMoments.clear();
+    return *this;
 }
 
 VectorXd MIA::predict(const MatrixXd& x) const {
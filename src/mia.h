@@ -10,12 +10,96 @@ enum class PolynomialType {
 	quadratic //!< \f$ f(x_i, x_j)=w_0+w_1x_i+w_2x_j+w_{12}x_ix_j+w_{11}x_i^2+w_{22}x_j^2 \f$ 
 };
 
+/**
+ * @brief Structure for storing the sums of the products of the powered data columns. 
+ * 
+ * The moments of the polynomial of any pair of columns are assembled from them without constructing the polynomial data
+ */
+struct GMDH_API PolynomialMoments {
+	MatrixXd x1x1; //!< Sums of \f$ x_ix_j \f$ for all pairs of columns
+	MatrixXd x2x1; //!< Sums of \f$ x_i^2x_j \f$ for all pairs of columns
+	MatrixXd x3x1; //!< Sums of \f$ x_i^3x_j \f$ for all pairs of columns
+	MatrixXd x2x2; //!< Sums of \f$ x_i^2x_j^2 \f$ for all pairs of columns
+	MatrixXd yx1x1; //!< Sums of \f$ yx_ix_j \f$ for all pairs of columns
+	MatrixXd xSums; //!< Sums of \f$ x_i^a \f$ for each column in the (a - 1)-th row
+	MatrixXd ySums; //!< Sums of \f$ yx_i^a \f$ for each column in the (a - 1)-th row
+	double y; //!< Sum of the target values
+	double yy; //!< Sum of squares of the target values
+	int64_t rows; //!< The number of data rows
+
+	/// @brief Construct empty PolynomialMoments object
+	PolynomialMoments() : y(0), yy(0), rows(0) {}
+
+	/**
+	 * @brief Construct a new PolynomialMoments object
+	 * 
+	 * @param x Matrix of input data without the column of ones
+	 * @param y Vector of the target values for the corresponding x data
+	 * @param polynomialType Polynomial type whose moments will be assembled. Only the required sums are calculated
+	 */
+	PolynomialMoments(const MatrixXd& x, const VectorXd& y, PolynomialType polynomialType);
+
+	/**
+	 * @brief Add the moments of other rows of the data with the same columns
+	 * 
+	 * @param other Moments of other data rows
+	 * @return A reference to this object
+	 */
+	PolynomialMoments& operator+=(const PolynomialMoments& other);
+
+	/**
+	 * @brief Get the moments of the polynomial data of the columns pair
+	 * 
+	 * @param i Index of the first column
+	 * @param j Index of the second column
+	 * @param polynomialType Selected polynomial type
+	 * @return Moments of the data that MIA::getPolynomialX() constructs for the columns pair and the column of ones
+	 */
+	DataMoments pairMoments(uint16_t i, uint16_t j, PolynomialType polynomialType) const;
+
+	/**
+	 * @brief Write the moments of the polynomial data of the columns pair to the existing object reusing its memory
+	 * 
+	 * @param i Index of the first column
+	 * @param j Index of the second column
+	 * @param polynomialType Selected polynomial type
+	 * @param moments Object to which the moments of the data that MIA::getPolynomialX() constructs will be written
+	 */
+	void pairMoments(uint16_t i, uint16_t j, PolynomialType polynomialType, DataMoments& moments) const;
+
+	/**
+	 * @brief Get the sum of the product of the powered columns
+	 * 
+	 * @param i Index of the first column
+	 * @param j Index of the second column
+	 * @param a Power of the first column
+	 * @param b Power of the second column
+	 * @return Sum of \f$ x_i^ax_j^b \f$
+	 */
+	double sum(uint16_t i, uint16_t j, int a, int b) const;
+
+	/**
+	 * @brief Get the sum of the product of the target values and the powered columns
+	 * 
+	 * @param i Index of the first column
+	 * @param j Index of the second column
+	 * @param a Power of the first column
+	 * @param b Power of the second column
+	 * @return Sum of \f$ yx_i^ax_j^b \f$
+	 */
+	double ySum(uint16_t i, uint16_t j, int a, int b) const;
+};
+
 /// @brief Class implementing multilayered iterative MIA algorithm
 class GMDH_API MIA : public GmdhModel {
 protected:
 	PolynomialType polynomialType; //!< Selected polynomial type
+	std::vector<PolynomialMoments> levelMoments; //!< Moments of the training, testing and learning data of the current level and the folds of the learning data used by Solver::gram
 
 	VectorVu16 generateCombinations(int n_cols) const override;
+	uint64_t prepareCombinations(int n_cols) override;
+	void prepareMoments(const SplittedData& data, int foldsNumber) override;
+	bool getCombinationMoments(const VectorU16& comb, SplittedMoments& moments) const override;
 
 	/**
 	 * @brief Construct vector of the new variable values according to the selected polynomial type
@@ -25,6 +109,15 @@ protected:
 	 */
 	MatrixXd getPolynomialX(const MatrixXd& x) const;
 
+	/**
+	 * @brief Write the new variable values for the given columns according to the selected polynomial type
+	 * 
+	 * @param x Matrix of input variables values
+	 * @param comb Indexes of the two columns of the polynomial and the column of ones
+	 * @param polyX Matrix for the new variable values. Its memory is reused if its size doesn't change
+	 */
+	void getPolynomialX(const MatrixXd& x, const VectorU16& comb, MatrixXd& polyX) const;
+
 	/**
 	 * @brief Transform data in the current training level by constructing new variables using selected polynomial type
 	 * 
@@ -33,9 +126,19 @@ protected:
 	 */
 	virtual void transformDataForNextLevel(SplittedData& data, const VectorC& bestCombinations);
 
+	/**
+	 * @brief Check that the models of the next levels can be constructed for the given parameters
+	 * 
+	 * @param kBest The number of best models based of which new models of the next level will be constructed
+	 * @param cols The number of the input data columns
+	 * @throw std::invalid_argument if kBest or cols value is less than 3
+	 */
+	void checkLevelsParameters(int kBest, Index cols) const;
+
 	virtual void removeExtraCombinations() override;
 	virtual bool preparations(SplittedData& data, VectorC&& _bestCombinations) override;
 	virtual MatrixXd xDataForCombination(const MatrixXd& x, const VectorU16& comb) const override;
+	virtual void xDataForCombination(const MatrixXd& x, const VectorU16& comb, MatrixXd& result) const override;
 
 	std::string getPolynomialPrefix(int levelIndex, int combIndex) const override;
 	std::string getPolynomialVariable(int levelIndex, int coeffIndex, int coeffsNumber, 
@@ -58,15 +161,50 @@ public:
      * @param threads The number of threads used for calculations. Set -1 to use max possible threads 
      * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
      * @param limit The minimum value by which the external criterion should be improved in order to continue training
+     * @param executor Thread pool shared with other training processes. If it is nullptr, 
+     * the pool with the given number of threads is created only for this training process
+     * @param token Token stopping the training process after the deadline or on request. If the training process 
+     * is stopped, the model is built from the already evaluated models and getFitReport() result is marked as truncated
 	 * @throw std::invalid_argument
 	 * @warning If the threads or verbose value is incorrect an exception won't be thrown. 
      * Insted, the incorrect value will be replaced with the default value and a corresponding warning will be displayed
      * @return A reference to the algorithm object for which the training was performed
+	 * @note With Solver::gram the sums of the products of the powered columns are calculated once per level by matrix products, 
+	 * so the cost of each polynomial doesn't depend on the number of data rows
      */
 	GmdhModel& fit(const MatrixXd& x, const VectorXd& y, 
 					const Criterion& criterion = Criterion(CriterionType::regularity), int kBest = 3,
 					PolynomialType _polynomialType = PolynomialType::quadratic, double testSize = 0.5,
-					int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0);
+					int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0, Executor* executor = nullptr,
+					CancellationToken* token = nullptr);
+
+	/**
+	 * @brief Fit the algorithm reading the data rows chunk by chunk without loading the whole data into memory
+	 * 
+	 * The sums of the products of the powered columns are accumulated by one pass over the chunks at each level. 
+	 * The columns of each chunk are built again by the best models of the previous levels, so the found models 
+	 * are the same as after fit() with the same data and Solver::gram
+	 * 
+	 * @param reader Source of the data rows
+	 * @param criterion Selected external criterion. It must use Solver::gram and be calculated from the moments of the data
+	 * @param kBest The number of best models based of which new models of the next level will be constructed
+	 * @param _polynomialType Selected polynomial type to be used to construct new variables from existing ones during training
+	 * @param testSize Fraction of the last data rows that should be used to evaluate models at each level
+	 * @param pAverage The number of best models based of which the external criterion for each level will be calculated
+	 * @param threads The number of threads used for calculations. Set -1 to use max possible threads 
+	 * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
+	 * @param limit The minimum value by which the external criterion should be improved in order to continue training
+	 * @param executor Thread pool shared with other training processes. If it is nullptr, 
+	 * the pool with the given number of threads is created only for this training process
+	 * @param token Token stopping the training process after the deadline or on request
+	 * @throw std::invalid_argument
+	 * @return A reference to the algorithm object for which the training was performed
+	 */
+	GmdhModel& fitChunks(ChunksReader& reader, 
+						const Criterion& criterion = Criterion(CriterionType::regularity, Solver::gram), int kBest = 3,
+						PolynomialType _polynomialType = PolynomialType::quadratic, double testSize = 0.5,
+						int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0, Executor* executor = nullptr,
+						CancellationToken* token = nullptr);
 
 	using GmdhModel::predict;
 	virtual VectorXd predict(const MatrixXd& x) const override;
@@ -1,29 +1,140 @@
 #include "multi.h"
 
 namespace GMDH {
-VectorVu16 MULTI::generateCombinations(int n_cols) const { // TODO: maybe change for bit masks 
-    VectorVu16 combs;
+VectorVu16 MULTI::generateCombinations(int n_cols) const {
+    return generateCombinations(n_cols, nullptr);
+}
+
+uint64_t MULTI::prepareCombinations(int n_cols) {
+    combinationsParents.clear();
+    levelCombinations = generateCombinations(n_cols, &combinationsParents);
+    levelCombinationsRange = CombinationsRange();
+    return levelCombinations.size();
+}
+
+bool MULTI::getDecompositionOrder(uint64_t index, const VectorU16&, VectorU16& order) const {
+    if (combinationsParents.empty())
+        return false;
+    const auto& parent{ combinationsParents[index] };
+    const auto& parentComb{ bestCombinations[0][parent.first].combination() };
+    order.assign(std::begin(parentComb), std::end(parentComb) - 1); // the parent columns without the column of ones
+    order.push_back(parent.second);
+    order.push_back(parentComb.back());
+    return true;
+}
+
+VectorVu16 MULTI::generateCombinations(int n_cols, std::vector<std::pair<int, uint16_t> >* combsParents) const {
     if (level == 1)
         return nChooseK(n_cols, level);
 
-    for (auto comb : bestCombinations[0]) {
-        for (auto i = 0; i < n_cols; ++i) {
-            auto temp{ comb.combination() };
-            if (std::find(std::begin(temp), std::end(temp), i) == std::end(temp)) {
-                temp.push_back(i);
-                std::sort(std::begin(temp), std::end(temp));
-                if (std::find(std::begin(combs), std::end(combs), temp) == std::end(combs))
-                    combs.push_back(std::move(temp));
-            }
+    // every candidate is a pair (parent, added column) identified by the position parent * n_cols + column,
+    // the set of columns of the candidate is hashed as XOR of random column keys (Zobrist hashing)
+    const auto& parents{ bestCombinations[0] };
+    auto parentsNumber{ parents.size() };
+    auto wordsNumber{ static_cast<size_t>(n_cols) / 64 + 1 };
+    std::vector<uint64_t> colsKeys(n_cols);
+    std::mt19937_64 generator(n_cols);
+    for (auto& key : colsKeys)
+        key = generator();
+
+    std::vector<uint64_t> masks(parentsNumber * wordsNumber, 0); // bit masks of the parents columns
+    std::vector<uint64_t> hashes(parentsNumber, 0);
+    for (size_t p = 0; p < parentsNumber; ++p) {
+        const auto& comb{ parents[p].combination() };
+        for (size_t j = 0; j + 1 < comb.size(); ++j) { // the last index is the column of ones
+            masks[p * wordsNumber + comb[j] / 64] |= uint64_t(1) << (comb[j] % 64);
+            hashes[p] ^= colsKeys[comb[j]];
         }
     }
+    auto hasColumn = [&masks, wordsNumber](uint64_t p, int col) {
+        return (masks[p * wordsNumber + col / 64] >> (col % 64)) & 1;
+    };
+    auto isSameCandidate = [&masks, &hasColumn, wordsNumber, n_cols](uint64_t first, uint64_t second) {
+        auto p1{ first / n_cols }, p2{ second / n_cols };
+        auto col1{ static_cast<int>(first % n_cols) }, col2{ static_cast<int>(second % n_cols) };
+        if (col1 == col2 || !hasColumn(p1, col2) || !hasColumn(p2, col1))
+            return col1 == col2 && p1 == p2;
+        for (size_t w = 0; w < wordsNumber; ++w) { // parent1 without col2 must be equal to parent2 without col1
+            auto word1{ masks[p1 * wordsNumber + w] }, word2{ masks[p2 * wordsNumber + w] };
+            if (static_cast<int>(w) == col2 / 64)
+                word1 &= ~(uint64_t(1) << (col2 % 64));
+            if (static_cast<int>(w) == col1 / 64)
+                word2 &= ~(uint64_t(1) << (col1 % 64));
+            if (word1 != word2)
+                return false;
+        }
+        return true;
+    };
+
+    // generating candidates of the parents portions and distributing them between hash partitions
+    auto tasksNumber{ static_cast<int>(std::max<size_t>(1, std::min<size_t>(threadsNumber, parentsNumber))) };
+    auto parentsPortion{ (parentsNumber + tasksNumber - 1) / tasksNumber };
+    using HashedCandidate = std::pair<uint64_t, uint64_t>;
+    std::vector<std::vector<std::vector<HashedCandidate> > > partitions(tasksNumber,
+        std::vector<std::vector<HashedCandidate> >(tasksNumber));
+    runTasks(tasksNumber, [&](int task) {
+        auto end{ std::min(parentsPortion * (task + 1), parentsNumber) };
+        for (auto p = parentsPortion * task; p < end; ++p)
+            for (auto col = 0; col < n_cols; ++col)
+                if (!hasColumn(p, col)) {
+                    auto hash{ hashes[p] ^ colsKeys[col] };
+                    partitions[task][(hash >> 32) % tasksNumber].emplace_back(hash, p * n_cols + col);
+                }
+    });
+
+    // keeping the first position of every unique candidate
+    std::vector<char> isUnique(parentsNumber * n_cols, 0);
+    runTasks(tasksNumber, [&](int partition) {
+        std::unordered_multimap<uint64_t, uint64_t> firstPositions;
+        for (auto task = 0; task < tasksNumber; ++task)
+            for (const auto& candidate : partitions[task][partition]) {
+                auto range{ firstPositions.equal_range(candidate.first) };
+                auto it{ range.first };
+                while (it != range.second && !isSameCandidate(it->second, candidate.second))
+                    ++it;
+                if (it == range.second)
+                    firstPositions.emplace(candidate.first, candidate.second);
+                else if (candidate.second < it->second)
+                    it->second = candidate.second;
+            }
+        for (const auto& position : firstPositions)
+            isUnique[position.second] = 1;
+    });
+
+    VectorVu16 combs;
+    for (size_t position = 0; position < isUnique.size(); ++position)
+        if (isUnique[position]) {
+            auto temp{ parents[position / n_cols].combination() };
+            auto col{ static_cast<uint16_t>(position % n_cols) };
+            temp.insert(std::upper_bound(std::begin(temp), std::end(temp), col), col);
+            combs.push_back(std::move(temp));
+            if (combsParents)
+                combsParents->emplace_back(static_cast<int>(position / n_cols), col);
+        }
     return combs;
 }
 
 GmdhModel& MULTI::fit(const MatrixXd& x, const VectorXd& y, const Criterion& criterion, int kBest, double testSize,
-    int pAverage, int threads, int verbose, double limit) {
-    validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, &kBest);
+    int pAverage, int threads, int verbose, double limit, Executor* executor, 
+    CancellationToken* token) {
+    validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, &kBest, executor);
+
+    return GmdhModel::gmdhFit(x, y, criterion, kBest, testSize, pAverage, threads, verbose, limit, executor, token);
+}
+
+GmdhModel& MULTI::partialFit(const MatrixXd& x, const VectorXd& y, const Criterion& criterion, int kBest, 
+    double testSize, int pAverage, int threads, int verbose, double limit, const MatrixXd& expiredX, 
+    const VectorXd& expiredY, Executor* executor, CancellationToken* token) {
+    validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, &kBest, executor);
+
+    return partialGmdhFit(x, y, expiredX, expiredY, criterion, kBest, testSize, pAverage, threads, verbose, limit, 
+                          executor, token);
+}
+
+GmdhModel& MULTI::fitChunks(ChunksReader& reader, const Criterion& criterion, int kBest, double testSize,
+    int pAverage, int threads, int verbose, double limit, Executor* executor, CancellationToken* token) {
+    validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, &kBest, executor);
 
-    return GmdhModel::gmdhFit(x, y, criterion, kBest, testSize, pAverage, threads, verbose, limit);
+    return GmdhModel::gmdhFit(reader, criterion, kBest, testSize, pAverage, threads, verbose, limit, executor, token);
 }
 }
\ No newline at end of file
@@ -5,8 +5,20 @@ namespace GMDH {
 
 /// @brief Class implementing combinatorial selection MULTI algorithm
 class GMDH_API MULTI : public LinearModel {
+    std::vector<std::pair<int, uint16_t> > combinationsParents; //!< Index of the parent model and the added column for each model structure of the current level
+
+    /**
+     * @brief Get new model structures for the new level of training
+     * 
+     * @param n_cols The number of existing predictive variables at the current training level
+     * @param combsParents Pointer to the vector to which the parent model index and the added column of each structure will be written
+     * @return Vector of new model structures
+     */
+    VectorVu16 generateCombinations(int n_cols, std::vector<std::pair<int, uint16_t> >* combsParents) const;
 protected:
     VectorVu16 generateCombinations(int n_cols) const override;
+    uint64_t prepareCombinations(int n_cols) override;
+    bool getDecompositionOrder(uint64_t index, const VectorU16& comb, VectorU16& order) const override;
 public:
     /// @brief Construct a new MULTI object
     MULTI() : LinearModel() {}
@@ -14,6 +26,64 @@ public:
     /// @copydoc GmdhModel::gmdhFit
     GmdhModel& fit(const MatrixXd& x, const VectorXd& y,
         const Criterion& criterion = Criterion(CriterionType::regularity), int kBest = 3,
-        double testSize = 0.5, int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0);
+        double testSize = 0.5, int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0, 
+        Executor* executor = nullptr, CancellationToken* token = nullptr);
+
+    /**
+     * @brief Fit the algorithm using the moments of all data rows appended by the previous calls and the new ones
+     * 
+     * The data rows aren't kept by the model, only the moments of its training and testing parts are updated by 
+     * the new rows and optionally by the expired ones for the sliding window. The testing rows are spread evenly 
+     * over the appended rows. The moments are kept between the calls independently of fit(), so a new sequence 
+     * of rows requires a new object
+     * 
+     * @param x Matrix of the new input data rows
+     * @param y Vector of the taget values for the corresponding x data
+     * @param criterion Selected external criterion. It must use Solver::gram and be calculated from the moments 
+     * of the training and testing data
+     * @param kBest The number of best models based of which new models of the next level will be constructed
+     * @param testSize Fraction of the data rows included into the testing part. It must be the same for all calls
+     * @param pAverage The number of best models based of which the external criterion for each level will be calculated
+     * @param threads The number of threads used for calculations. Set -1 to use max possible threads 
+     * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
+     * @param limit The minimum value by which the external criterion should be improved in order to continue training
+     * @param expiredX Matrix of the oldest previously appended data rows that must be removed, in their original order
+     * @param expiredY Vector of the taget values for the corresponding expiredX data
+     * @param executor Thread pool shared with other training processes. If it is nullptr, 
+     * the pool with the given number of threads is created only for this training process
+     * @param token Token stopping the training process after the deadline or on request
+     * @throw std::invalid_argument
+     * @return A reference to the algorithm object for which the training was performed
+     */
+    GmdhModel& partialFit(const MatrixXd& x, const VectorXd& y,
+        const Criterion& criterion = Criterion(CriterionType::regularity, Solver::gram), int kBest = 3,
+        double testSize = 0.5, int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0, 
+        const MatrixXd& expiredX = MatrixXd(), const VectorXd& expiredY = VectorXd(), 
+        Executor* executor = nullptr, CancellationToken* token = nullptr);
+
+    /**
+     * @brief Fit the algorithm reading the data rows chunk by chunk without loading the whole data into memory
+     * 
+     * The moments of the training and testing parts are accumulated by one pass over the chunks, 
+     * so the found models are the same as after fit() with the same data and Solver::gram
+     * 
+     * @param reader Source of the data rows
+     * @param criterion Selected external criterion. It must use Solver::gram and be calculated from the moments of the data
+     * @param kBest The number of best models based of which new models of the next level will be constructed
+     * @param testSize Fraction of the last data rows that should be used to evaluate models at each level
+     * @param pAverage The number of best models based of which the external criterion for each level will be calculated
+     * @param threads The number of threads used for calculations. Set -1 to use max possible threads 
+     * @param verbose 1 if the printing detailed infomation about training process is needed, otherwise 0
+     * @param limit The minimum value by which the external criterion should be improved in order to continue training
+     * @param executor Thread pool shared with other training processes. If it is nullptr, 
+     * the pool with the given number of threads is created only for this training process
+     * @param token Token stopping the training process after the deadline or on request
+     * @throw std::invalid_argument
+     * @return A reference to the algorithm object for which the training was performed
+     */
+    GmdhModel& fitChunks(ChunksReader& reader,
+        const Criterion& criterion = Criterion(CriterionType::regularity, Solver::gram), int kBest = 3,
+        double testSize = 0.5, int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0, 
+        Executor* executor = nullptr, CancellationToken* token = nullptr);
 };
 }
\ No newline at end of file
@@ -12,8 +12,14 @@ VectorVu16 RIA::generateCombinations(int n_cols) const {
 	return combs;
 }
 
+uint64_t RIA::prepareCombinations(int n_cols) {
+	if (level == 1)
+		return MIA::prepareCombinations(n_cols);
+	return GmdhModel::prepareCombinations(n_cols);
+}
+
 void RIA::transformDataForNextLevel(SplittedData& data, const VectorC& bestCombinations) {
-	if (level == 1) {
+	if (data.xTrain.cols() == inputColsNumber + 1) { // the columns of the first level models are added once
 		data.xTrain.conservativeResize(NoChange, data.xTrain.cols() + bestCombinations.size());
 		data.xTest.conservativeResize(NoChange, data.xTest.cols() + bestCombinations.size());
 		data.xTrain.col(data.xTrain.cols() - 1) = VectorXd::Ones(data.xTrain.rows());
@@ -71,11 +77,26 @@ std::string RIA::getPolynomialVariable(int levelIndex, int coeffIndex, int coeff
 
 GmdhModel& RIA::fit(const MatrixXd& x, const VectorXd& y, const Criterion& criterion, int kBest,
 	PolynomialType _polynomialType, double testSize, int pAverage,
-	int threads, int verbose, double limit) {
+	int threads, int verbose, double limit, Executor* executor, 
+	CancellationToken* token) {
+
+	validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, &kBest, executor);
+	polynomialType = _polynomialType;
+	GmdhModel::gmdhFit(x, y, criterion, kBest, testSize, pAverage, threads, verbose, limit, executor, token);
+	levelMoments.clear();
+	return *this;
+}
+
+GmdhModel& RIA::fitChunks(ChunksReader& reader, const Criterion& criterion, int kBest,
+	PolynomialType _polynomialType, double testSize, int pAverage,
+	int threads, int verbose, double limit, Executor* executor, 
+	CancellationToken* token) {
 
-	validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, &kBest);
+	validateInputData(&testSize, &pAverage, &threads, &verbose, &limit, &kBest, executor);
 	polynomialType = _polynomialType;
-	return GmdhModel::gmdhFit(x, y, criterion, kBest, testSize, pAverage, threads, verbose, limit);
+	GmdhModel::gmdhFit(reader, criterion, kBest, testSize, pAverage, threads, verbose, limit, executor, token);
+	levelMoments.clear();
+	return *this;
 }
 
 VectorXd RIA::predict(const MatrixXd& x) const {
@@ -7,6 +7,7 @@ namespace GMDH {
 class GMDH_API RIA : public MIA {
 protected:
 	VectorVu16 generateCombinations(int n_cols) const override;
+	uint64_t prepareCombinations(int n_cols) override;
 	void transformDataForNextLevel(SplittedData& data, const VectorC& bestCombinations) override;
 	void removeExtraCombinations() override;
 	std::string getPolynomialPrefix(int levelIndex, int combIndex) const override;
@@ -17,7 +18,15 @@ public:
 	GmdhModel& fit(const MatrixXd& x, const VectorXd& y,
 		const Criterion& criterion = Criterion(CriterionType::regularity), int kBest = 1,
 		PolynomialType _polynomialType = PolynomialType::quadratic, double testSize = 0.5,
-		int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0);
+		int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0, Executor* executor = nullptr,
+		CancellationToken* token = nullptr);
+
+	/// @copydoc MIA::fitChunks
+	GmdhModel& fitChunks(ChunksReader& reader, 
+		const Criterion& criterion = Criterion(CriterionType::regularity, Solver::gram), int kBest = 1,
+		PolynomialType _polynomialType = PolynomialType::quadratic, double testSize = 0.5,
+		int pAverage = 1, int threads = 1, int verbose = 0, double limit = 0, Executor* executor = nullptr,
+		CancellationToken* token = nullptr);
 
 	using GmdhModel::predict;	
 	VectorXd predict(const MatrixXd& x) const override;
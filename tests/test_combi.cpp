@@ -1,6 +1,7 @@
 #include "test_setup.h"
 #include <combi.h>
 #include <ria.h>
+#include <thread>
 
 class TestCOMBI : public TestGmdhModel {
 protected:
@@ -107,6 +108,57 @@ TEST_F(TestCOMBI, testParallelCriterionAllSolvers) {
 }
 
 
+TEST_F(TestCOMBI, testGramSolver) {
+    auto testData = getTestData();
+    for (auto i: allCriterionTypes) {
+        static_cast<COMBI*>(testModel)->fit(testData.dataValues.xTrain, testData.dataValues.yTrain, Criterion(i, Solver::gram));
+        auto errorMsg = testPredict(testData.dataValues.xTest, testData.realPredValues);
+        EXPECT_TRUE(errorMsg.empty()) << errorMsg+" with criterion #"+std::to_string(static_cast<int>(i));
+    }
+
+    MatrixXd x = randomData(100, 6);
+    VectorXd y = x.col(0) * 2 - x.col(2) + x.col(5) * 0.5 + randomData(100, 1, 1).col(0) * 0.1;
+    COMBI qrModel;
+    for (auto i: allCriterionTypes) {
+        static_cast<COMBI*>(testModel)->fit(x, y, Criterion(i, Solver::gram));
+        qrModel.fit(x, y, Criterion(i, Solver::accurate));
+        EXPECT_TRUE(testModel->predict(x).isApprox(qrModel.predict(x), 1e-8)) << "with criterion #"+std::to_string(static_cast<int>(i));
+    }
+}
+
+
+TEST_F(TestCOMBI, testSubsetTreeSearch) {
+    MatrixXd x = randomData(60, 22);
+    VectorXd y = x.col(3) * 2 - x.col(10) + x.col(21) * 0.5 + randomData(60, 1, 1).col(0) * 0.1;
+    COMBI qrModel;
+    static_cast<COMBI*>(testModel)->fit(x, y, Criterion(CriterionType::regularity, Solver::gram), 0.5, 1, 1, 0, 0.05);
+    qrModel.fit(x, y, Criterion(CriterionType::regularity, Solver::fast), 0.5, 1, 1, 0, 0.05);
+    EXPECT_EQ(testModel->getBestPolynomial(), qrModel.getBestPolynomial());
+    EXPECT_TRUE(testModel->predict(x).isApprox(qrModel.predict(x), 1e-8));
+}
+
+
+TEST_F(TestCOMBI, testBranchAndBoundSearch) {
+    MatrixXd x = randomData(120, 30);
+    VectorXd y = x.col(5) * 3 - x.col(17) * 2 + x.col(29) + randomData(120, 1, 1).col(0) * 0.05;
+    COMBI prunedModel;
+    for (auto criterionType : { CriterionType::regularity, CriterionType::symStability }) {
+        Criterion criterion(criterionType, Solver::gram);
+        static_cast<COMBI*>(testModel)->fit(x, y, criterion, 0.5, 3, 1, 0, 0.01);
+        prunedModel.fit(x, y, criterion, 0.5, 3, 2, 0, 0.01, true);
+        EXPECT_EQ(testModel->getBestPolynomial(), prunedModel.getBestPolynomial());
+        auto report = prunedModel.getFitReport();
+        ASSERT_EQ(report.prunedCombinations.size(), testModel->getFitReport().evaluatedCombinations.size());
+        EXPECT_GT(std::accumulate(std::begin(report.prunedCombinations), std::end(report.prunedCombinations), 0ull), 0ull);
+        EXPECT_EQ(report.evaluatedCombinations[0] + report.prunedCombinations[0], 30u);
+    }
+    EXPECT_THROW(prunedModel.fit(x, y, Criterion(CriterionType::regularity, Solver::fast), 0.5, 1, 1, 0, 0, true), 
+        std::invalid_argument);
+    EXPECT_THROW(prunedModel.fit(x, y, Criterion(CriterionType::unbiasedCoeffs, Solver::gram), 0.5, 1, 1, 0, 0, true), 
+        std::invalid_argument);
+}
+
+
 TEST_F(TestCOMBI, testSequentialCriterion) {
     auto testData = getTestData();
     SequentialCriterion criterion(CriterionType::regularity, CriterionType::unbiasedOutputs);
@@ -119,6 +171,302 @@ TEST_F(TestCOMBI, testSequentialCriterion) {
 }
 
 
+TEST_F(TestCOMBI, testSequentialCriterionRecalculation) {
+    MatrixXd x = randomData(80, 8);
+    VectorXd y = x.col(1) * 3 + x.col(4) - x.col(6) * 0.5 + randomData(80, 1, 1).col(0) * 0.1;
+    for (auto secondType : { CriterionType::symRegularity, CriterionType::absoluteNoiseImmunity, CriterionType::crossValidation }) {
+        COMBI gramModel;
+        static_cast<COMBI*>(testModel)->fit(x, y, SequentialCriterion(CriterionType::regularity, secondType, 0, Solver::accurate), 
+                                            0.5, 1, 3);
+        gramModel.fit(x, y, SequentialCriterion(CriterionType::regularity, secondType, 0, Solver::gram), 0.5, 1, 3);
+        EXPECT_TRUE(testModel->predict(x).isApprox(gramModel.predict(x), 1e-8)) 
+            << "with second criterion #"+std::to_string(static_cast<int>(secondType));
+    }
+}
+
+
+TEST_F(TestCOMBI, testSequentialCriterionTopLimit) {
+    MatrixXd x = randomData(80, 8);
+    VectorXd y = x.col(1) * 3 + x.col(4) - x.col(6) * 0.5 + randomData(80, 1, 1).col(0) * 0.1;
+    COMBI limitedModel;
+    static_cast<COMBI*>(testModel)->fit(x, y, SequentialCriterion(CriterionType::regularity, CriterionType::stability, 
+                                                                  3, Solver::gram));
+    limitedModel.fit(x, y, SequentialCriterion(CriterionType::regularity, CriterionType::stability, 0, Solver::gram, 3));
+    EXPECT_EQ(limitedModel.getBestPolynomial(), testModel->getBestPolynomial());
+    EXPECT_THROW(SequentialCriterion(CriterionType::regularity, CriterionType::stability, 0, Solver::gram, -1), 
+                 std::invalid_argument);
+}
+
+
+TEST_F(TestCOMBI, testMultithreadedSelection) {
+    MatrixXd x = randomData(80, 8);
+    VectorXd y = x.col(1) * 3 + x.col(4) - x.col(6) * 0.5 + randomData(80, 1, 1).col(0) * 0.1;
+    SequentialCriterion criterion(CriterionType::regularity, CriterionType::stability);
+    COMBI secondModel;
+    static_cast<COMBI*>(testModel)->fit(x, y, criterion, 0.5, 1, 1);
+    secondModel.fit(x, y, criterion, 0.5, 1, 3);
+    EXPECT_EQ(testModel->getBestPolynomial(), secondModel.getBestPolynomial());
+}
+
+
+TEST_F(TestCOMBI, testSharedExecutor) {
+    MatrixXd x = randomData(80, 8);
+    VectorXd y = x.col(1) * 3 + x.col(4) - x.col(6) * 0.5 + randomData(80, 1, 1).col(0) * 0.1;
+    Criterion criterion(CriterionType::regularity);
+    static_cast<COMBI*>(testModel)->fit(x, y, criterion);
+    Executor executor(3);
+    COMBI firstModel, secondModel;
+    std::thread concurrentFit([&]() { firstModel.fit(x, y, criterion, 0.5, 1, -1, 0, 0, false, &executor); });
+    secondModel.fit(x, y, criterion, 0.5, 1, 2, 0, 0, false, &executor);
+    concurrentFit.join();
+    EXPECT_EQ(testModel->getBestPolynomial(), firstModel.getBestPolynomial());
+    EXPECT_EQ(testModel->getBestPolynomial(), secondModel.getBestPolynomial());
+    EXPECT_THROW(Executor(0), std::invalid_argument);
+}
+
+
+TEST_F(TestCOMBI, testCancellation) {
+    MatrixXd x = randomData(80, 8);
+    VectorXd y = x.col(1) * 3 + x.col(4) - x.col(6) * 0.5 + randomData(80, 1, 1).col(0) * 0.1;
+    Criterion criterion(CriterionType::regularity, Solver::gram);
+    CancellationToken token;
+    testModel->setProgressCallback([&token](const ProgressInfo& info) {
+        if (info.levelCompleted && info.level == 2)
+            token.cancel();
+    });
+    static_cast<COMBI*>(testModel)->fit(x, y, criterion, 0.5, 1, 2, 0, 0, false, nullptr, &token);
+    EXPECT_TRUE(testModel->getFitReport().truncated);
+    EXPECT_LE(testModel->getFitReport().evaluatedCombinations.size(), 2);
+    EXPECT_EQ(testModel->predict(x).size(), x.rows());
+
+    COMBI expiredModel;
+    CancellationToken expiredToken(0);
+    expiredModel.fit(x, y, criterion, 0.5, 1, 2, 0, 0, false, nullptr, &expiredToken);
+    EXPECT_TRUE(expiredModel.getFitReport().truncated);
+    EXPECT_EQ(expiredModel.getFitReport().evaluatedCombinations.size(), 1);
+    EXPECT_GE(expiredModel.getFitReport().evaluatedCombinations[0], 1);
+    EXPECT_EQ(expiredModel.predict(x).size(), x.rows());
+
+    COMBI fullModel;
+    CancellationToken distantToken(1e6);
+    fullModel.fit(x, y, criterion, 0.5, 1, 2, 0, 0, false, nullptr, &distantToken);
+    EXPECT_FALSE(fullModel.getFitReport().truncated);
+    EXPECT_THROW(CancellationToken(-2), std::invalid_argument);
+}
+
+
+TEST_F(TestCOMBI, testProgressCallback) {
+    MatrixXd x = randomData(80, 8);
+    VectorXd y = x.col(1) * 3 + x.col(4) - x.col(6) * 0.5 + randomData(80, 1, 1).col(0) * 0.1;
+    std::vector<ProgressInfo> completedLevels;
+    testModel->setProgressCallback([&completedLevels](const ProgressInfo& info) {
+        if (info.levelCompleted)
+            completedLevels.push_back(info);
+    });
+    static_cast<COMBI*>(testModel)->fit(x, y, Criterion(CriterionType::regularity, Solver::gram), 0.5, 1, 2);
+    const auto& report = testModel->getFitReport();
+    ASSERT_EQ(completedLevels.size(), report.evaluatedCombinations.size());
+    for (size_t i = 0; i < completedLevels.size(); ++i) {
+        EXPECT_EQ(completedLevels[i].level, static_cast<int>(i) + 1);
+        EXPECT_EQ(completedLevels[i].doneCombinations, completedLevels[i].combinationsNumber);
+        EXPECT_EQ(completedLevels[i].doneCombinations, report.evaluatedCombinations[i] + report.prunedCombinations[i]);
+        EXPECT_LT(completedLevels[i].bestEvaluation, std::numeric_limits<double>::max());
+    }
+
+    auto bestPolynomial{ testModel->getBestPolynomial() };
+    testModel->setProgressCallback([](const ProgressInfo& info) { // the training process is left after the level
+        if (info.levelCompleted)
+            throw std::runtime_error("callback error");
+    });
+    EXPECT_THROW(static_cast<COMBI*>(testModel)->fit(x, y, Criterion(CriterionType::regularity, Solver::gram), 0.5, 1, 2), 
+                 std::runtime_error);
+    testModel->setProgressCallback(nullptr);
+    static_cast<COMBI*>(testModel)->fit(x, y, Criterion(CriterionType::regularity, Solver::gram), 0.5, 1, 2);
+    EXPECT_EQ(testModel->getBestPolynomial(), bestPolynomial) 
+        << "[ TEST_MSG ]: the state of the stopped training process must be reset";
+}
+
+
+TEST_F(TestCOMBI, testScreening) {
+    MatrixXd x = randomData(2000, 8);
+    VectorXd y = x.col(1) * 3 + x.col(4) - x.col(6) * 0.5 + randomData(2000, 1, 1).col(0) * 0.1;
+    Criterion criterion(CriterionType::regularity);
+    static_cast<COMBI*>(testModel)->fit(x, y, criterion);
+    EXPECT_TRUE(testModel->getFitReport().screeningRecall.empty());
+    COMBI screenedModel;
+    screenedModel.setScreening(0.1, 10);
+    screenedModel.fit(x, y, criterion);
+    EXPECT_EQ(testModel->getBestPolynomial(), screenedModel.getBestPolynomial());
+    const auto& report = screenedModel.getFitReport();
+    ASSERT_EQ(report.screeningRecall.size(), report.evaluatedCombinations.size());
+    for (auto recall : report.screeningRecall) {
+        EXPECT_GT(recall, 0);
+        EXPECT_LE(recall, 1);
+    }
+    EXPECT_THROW(screenedModel.setScreening(0, 10), std::invalid_argument);
+    EXPECT_THROW(screenedModel.setScreening(1.5, 10), std::invalid_argument);
+}
+
+
+TEST_F(TestCOMBI, testAdaptiveSolver) {
+    MatrixXd x = randomData(80, 6);
+    VectorXd y = x.col(0) * 2 - x.col(2) + x.col(5) * 0.5 + randomData(80, 1, 1).col(0) * 0.1;
+    COMBI adaptiveModel;
+    static_cast<COMBI*>(testModel)->fit(x, y, Criterion(CriterionType::regularity, Solver::accurate));
+    adaptiveModel.fit(x, y, Criterion(CriterionType::regularity, Solver::adaptive));
+    EXPECT_TRUE(testModel->predict(x).isApprox(adaptiveModel.predict(x), 1e-8));
+    const auto& report = adaptiveModel.getFitReport();
+    ASSERT_EQ(report.escalatedCombinations.size(), report.evaluatedCombinations.size());
+    EXPECT_EQ(std::accumulate(std::begin(report.escalatedCombinations), std::end(report.escalatedCombinations), uint64_t(0)), 0)
+        << "[ TEST_MSG ]: the well conditioned models must be solved by the fast decomposition";
+
+    x.col(4) = x.col(0) - x.col(1) * 0.5; // the models containing all three columns are rank deficient
+    static_cast<COMBI*>(testModel)->fit(x, y, Criterion(CriterionType::regularity, Solver::accurate));
+    adaptiveModel.fit(x, y, Criterion(CriterionType::regularity, Solver::adaptive));
+    EXPECT_TRUE(testModel->predict(x).isApprox(adaptiveModel.predict(x), 1e-8));
+    EXPECT_GT(std::accumulate(std::begin(report.escalatedCombinations), std::end(report.escalatedCombinations), uint64_t(0)), 0);
+
+    adaptiveModel.fit(x, y, Criterion(CriterionType::symRegularity, Solver::adaptive));
+    EXPECT_GT(std::accumulate(std::begin(report.escalatedCombinations), std::end(report.escalatedCombinations), uint64_t(0)), 0);
+    for (size_t i = 0; i < report.escalatedCombinations.size(); ++i) // both decompositions of the model are escalated
+        EXPECT_LE(report.escalatedCombinations[i], report.evaluatedCombinations[i]) << "[ TEST_MSG ]: the model must be counted once";
+}
+
+TEST_F(TestCOMBI, testLeaveOneOut) {
+    MatrixXd x = randomData(60, 6);
+    VectorXd y = x.col(0) * 2 - x.col(2) + x.col(5) * 0.5 + randomData(60, 1, 1).col(0) * 0.1;
+    static_cast<COMBI*>(testModel)->fit(x, y, Criterion(CriterionType::leaveOneOut, Solver::accurate));
+    for (auto solver : { Solver::fast, Solver::balanced, Solver::gram }) {
+        COMBI model;
+        model.fit(x, y, Criterion(CriterionType::leaveOneOut, solver));
+        EXPECT_TRUE(testModel->predict(x).isApprox(model.predict(x), 1e-8)) << "with solver #"+std::to_string(static_cast<int>(solver));
+    }
+    COMBI parallelModel, accurateParallelModel, sequentialModel;
+    parallelModel.fit(x, y, ParallelCriterion(CriterionType::leaveOneOut, CriterionType::regularity, 0.5, Solver::gram));
+    accurateParallelModel.fit(x, y, ParallelCriterion(CriterionType::leaveOneOut, CriterionType::regularity, 0.5, 
+                                                      Solver::accurate));
+    sequentialModel.fit(x, y, SequentialCriterion(CriterionType::regularity, CriterionType::leaveOneOut, 0, Solver::gram));
+    EXPECT_EQ(parallelModel.getBestPolynomial(), accurateParallelModel.getBestPolynomial());
+    EXPECT_EQ(sequentialModel.getBestPolynomial(), testModel->getBestPolynomial());
+
+    x.col(4) = x.col(0) * 2; // the models containing both columns are rank deficient
+    std::vector<CriterionType> criteria{ CriterionType::leaveOneOut };
+    COMBI accurateModel, fastModel;
+    accurateModel.setScoredCriteria(criteria);
+    fastModel.setScoredCriteria(criteria);
+    accurateModel.fit(x, y, Criterion(CriterionType::regularity, Solver::accurate));
+    fastModel.fit(x, y, Criterion(CriterionType::regularity, Solver::fast));
+    const auto& accurateScores{ accurateModel.getFitReport().criteriaScores };
+    const auto& fastScores{ fastModel.getFitReport().criteriaScores };
+    ASSERT_GT(fastScores.size(), 1);
+    EXPECT_TRUE(fastScores[1].allFinite());
+    EXPECT_TRUE(fastScores[1].isApprox(accurateScores[1], 1e-8)) 
+        << "[ TEST_MSG ]: the leverages of the rank deficient models must be calculated using the pivoted decomposition";
+
+    MatrixXd smallX = x.topRows(12).leftCols(3);
+    VectorXd smallY = y.head(12);
+    for (auto solver : { Solver::fast, Solver::accurate, Solver::gram }) { // the first level models contain one column
+        COMBI scoredModel;
+        scoredModel.setScoredCriteria(criteria);
+        scoredModel.fit(smallX, smallY, Criterion(CriterionType::regularity, solver));
+        const auto& scores{ scoredModel.getFitReport().criteriaScores };
+        ASSERT_FALSE(scores.empty());
+        for (Index col = 0; col < smallX.cols(); ++col) {
+            MatrixXd modelX(smallX.rows(), 2);
+            modelX << smallX.col(col), VectorXd::Ones(smallX.rows());
+            double press{ 0 };
+            for (Index row = 0; row < modelX.rows(); ++row) { // the model is trained again without each row
+                MatrixXd otherX(modelX.rows() - 1, 2);
+                VectorXd otherY(modelX.rows() - 1);
+                otherX << modelX.topRows(row), modelX.bottomRows(modelX.rows() - row - 1);
+                otherY << smallY.head(row), smallY.tail(modelX.rows() - row - 1);
+                VectorXd coeffs = otherX.colPivHouseholderQr().solve(otherY);
+                press += std::pow(smallY[row] - modelX.row(row).dot(coeffs), 2);
+            }
+            EXPECT_NEAR(scores[0](col, 0), press, 1e-9 * press) << "with solver #"+std::to_string(static_cast<int>(solver));
+        }
+    }
+}
+
+TEST_F(TestCOMBI, testScoredCriteria) {
+    MatrixXd x = randomData(60, 6);
+    VectorXd y = x.col(0) * 2 - x.col(2) + x.col(5) * 0.5 + randomData(60, 1, 1).col(0) * 0.1;
+    std::vector<CriterionType> criteria{ CriterionType::regularity, CriterionType::leaveOneOut, CriterionType::stability };
+    testModel->setScoredCriteria(criteria);
+    static_cast<COMBI*>(testModel)->fit(x, y, Criterion(CriterionType::regularity, Solver::accurate));
+    const auto& scores{ testModel->getFitReport().criteriaScores };
+    ASSERT_EQ(scores.size(), testModel->getFitReport().evaluatedCombinations.size());
+    ASSERT_EQ(scores[0].rows(), 6);
+    ASSERT_EQ(scores[0].cols(), 3);
+    EXPECT_FALSE(scores[0].hasNaN());
+
+    COMBI unscoredModel;
+    unscoredModel.fit(x, y, Criterion(CriterionType::regularity, Solver::accurate));
+    EXPECT_EQ(unscoredModel.getBestPolynomial(), testModel->getBestPolynomial());
+    EXPECT_TRUE(unscoredModel.getFitReport().criteriaScores.empty());
+
+    for (auto solver : { Solver::fast, Solver::gram }) {
+        COMBI model;
+        model.setScoredCriteria(criteria);
+        model.fit(x, y, Criterion(CriterionType::leaveOneOut, solver));
+        EXPECT_TRUE(model.getFitReport().criteriaScores[0].isApprox(scores[0], 1e-8)) << "with solver #"+std::to_string(static_cast<int>(solver));
+    }
+}
+
+TEST_F(TestCOMBI, testPartialFit) {
+    MatrixXd x = randomData(80, 5);
+    VectorXd y = x.col(1) * 3 - x.col(3) + randomData(80, 1, 1).col(0) * 0.1;
+    Criterion criterion(CriterionType::regularity, Solver::gram);
+    auto partialModel{ static_cast<COMBI*>(testModel) };
+    partialModel->partialFit(x.topRows(30), y.head(30), criterion);
+    partialModel->partialFit(x.middleRows(30, 30), y.segment(30, 30), criterion);
+
+    std::vector<Index> rows; // the odd appended rows are the testing ones
+    for (Index i = 0; i < 60; i += 2)
+        rows.push_back(i);
+    for (Index i = 1; i < 60; i += 2)
+        rows.push_back(i);
+    COMBI model;
+    model.fit(x(rows, Eigen::all), y(rows), criterion);
+    EXPECT_TRUE(partialModel->predict(x).isApprox(model.predict(x), 1e-8));
+
+    partialModel->partialFit(x.bottomRows(20), y.tail(20), criterion, 0.5, 1, 1, 0, 0, true, 
+                             x.topRows(20), y.head(20));
+    COMBI windowModel;
+    windowModel.partialFit(x.bottomRows(60), y.tail(60), criterion);
+    EXPECT_TRUE(partialModel->predict(x).isApprox(windowModel.predict(x), 1e-8));
+
+    EXPECT_THROW(partialModel->partialFit(x, y, Criterion(CriterionType::regularity, Solver::fast)), std::invalid_argument);
+    EXPECT_THROW(partialModel->partialFit(x, y, Criterion(CriterionType::leaveOneOut, Solver::gram)), std::invalid_argument);
+    EXPECT_THROW(partialModel->partialFit(x, y, criterion, 0.25), std::invalid_argument);
+    EXPECT_THROW(partialModel->partialFit(x.leftCols(4), y, criterion), std::invalid_argument);
+    EXPECT_THROW(partialModel->partialFit(x.topRows(1), y.head(1), criterion, 0.5, 1, 1, 0, 0, false, x, y), 
+                 std::invalid_argument);
+}
+
+TEST_F(TestCOMBI, testFitChunks) {
+    MatrixXd x = randomData(90, 6);
+    VectorXd y = x.col(0) * 2 - x.col(4) + randomData(90, 1, 1).col(0) * 0.1;
+    writeChunksFile("gtest_chunks.bin", x, y);
+    {
+        FileChunksReader fileReader("gtest_chunks.bin", 6, 16);
+        auto memoryReader{ memoryChunksReader(x, y, 25) };
+        for (auto criterionType : { CriterionType::regularity, CriterionType::crossValidation }) {
+            Criterion criterion(criterionType, Solver::gram);
+            static_cast<COMBI*>(testModel)->fit(x, y, criterion, 0.3);
+            COMBI fileModel, memoryModel;
+            fileModel.fitChunks(fileReader, criterion, 0.3);
+            memoryModel.fitChunks(memoryReader, criterion, 0.3, 1, 1, 0, 0, criterionType == CriterionType::regularity);
+            EXPECT_TRUE(fileModel.predict(x).isApprox(testModel->predict(x), 1e-8)) << "with criterion #"+std::to_string(static_cast<int>(criterionType));
+            EXPECT_TRUE(memoryModel.predict(x).isApprox(testModel->predict(x), 1e-8)) << "with criterion #"+std::to_string(static_cast<int>(criterionType));
+        }
+        COMBI model;
+        EXPECT_THROW(model.fitChunks(fileReader, Criterion(CriterionType::regularity, Solver::fast)), std::invalid_argument);
+        EXPECT_THROW(model.fitChunks(fileReader, Criterion(CriterionType::leaveOneOut, Solver::gram)), std::invalid_argument);
+    }
+    std::remove("gtest_chunks.bin");
+}
+
 TEST_F(TestCOMBI, testGetBestPolinomial) {
     auto testData = getTestData();
     static_cast<COMBI*>(testModel)->fit(testData.dataValues.xTrain, testData.dataValues.yTrain);
@@ -110,3 +110,248 @@ TEST(testParallelCriterion, testConstructorIncorrectData) {
     EXPECT_THROW(ParallelCriterion criterion(CriterionType::regularity, CriterionType::stability, 10), std::invalid_argument) << "[ TEST_MSG ]: alpha > 1"; 
 }
 
+
+TEST(testCombinationsRange, testEnumeration) {
+    int n = 7, k = 3;
+    CombinationsRange range(n, k);
+    ASSERT_EQ(range.size(), 35);
+    VectorU16 comb, expected;
+    for (uint64_t i = 0; i < range.size(); ++i) {
+        if (i == 0)
+            range.combination(i, expected);
+        else
+            range.next(expected);
+        range.combination(i, comb);
+        ASSERT_EQ(comb, expected) << "[ TEST_MSG ]: wrong combination with index " << i;
+        ASSERT_EQ(comb.size(), k + 1);
+        ASSERT_EQ(comb.back(), n);
+        ASSERT_TRUE(std::is_sorted(std::begin(comb), std::end(comb) - 1));
+    }
+    EXPECT_EQ(comb, VectorU16({ 4, 5, 6, 7 }));
+}
+
+TEST(testCombinationsRange, testBinomial) {
+    EXPECT_EQ(CombinationsRange::binomial(5, 0), 1);
+    EXPECT_EQ(CombinationsRange::binomial(5, 6), 0);
+    EXPECT_EQ(CombinationsRange::binomial(40, 20), 137846528820ULL);
+    EXPECT_EQ(CombinationsRange::binomial(62, 31), 465428353255261088ULL);
+    EXPECT_THROW(CombinationsRange::binomial(70, 35), std::overflow_error);
+}
+
+TEST(testChunksScheduler, testCoverage) {
+    std::atomic<uint64_t> nextIndex{ 0 };
+    ChunksScheduler first(nextIndex, 1000, 2), second(nextIndex, 1000, 2);
+    std::vector<int> taken(1000, 0);
+    uint64_t beginIndex, endIndex;
+    auto firstTaken{ true }, secondTaken{ true };
+    while (firstTaken || secondTaken) {
+        for (auto chunks : { &first, &second }) {
+            auto& isTaken{ chunks == &first ? firstTaken : secondTaken };
+            if (isTaken && (isTaken = chunks->next(beginIndex, endIndex))) {
+                ASSERT_LT(beginIndex, endIndex);
+                for (auto index = beginIndex; index < endIndex; ++index)
+                    ++taken[index];
+            }
+        }
+    }
+    EXPECT_EQ(std::count(std::begin(taken), std::end(taken), 1), 1000) << "[ TEST_MSG ]: the models must be taken exactly once";
+    EXPECT_FALSE(first.next(beginIndex, endIndex));
+}
+
+TEST(testIncrementalCholesky, testCollinearColumns) {
+    MatrixXd x = MatrixXd::Random(30, 4);
+    x.col(2) = x.col(0) * 2 - x.col(1);
+    VectorXd y = x.col(0) + x.col(3) * 3;
+    DataMoments moments(x, y);
+    IncrementalCholesky cholesky;
+    EXPECT_TRUE(cholesky.append(moments, 0));
+    EXPECT_TRUE(cholesky.append(moments, 1));
+    EXPECT_FALSE(cholesky.append(moments, 2)) << "[ TEST_MSG ]: linearly dependent column is included";
+    EXPECT_TRUE(cholesky.append(moments, 3));
+    EXPECT_EQ(cholesky.rank(), 3);
+    VectorXd coeffs = cholesky.coeffs();
+    EXPECT_EQ(coeffs[2], 0);
+    EXPECT_TRUE((x * coeffs).isApprox(y, 1e-8));
+    EXPECT_NEAR(cholesky.residualsSquare(moments), 0, 1e-8);
+}
+
+TEST(testIncrementalCholesky, testSubsetsWalk) {
+    int n = 6, k = 3;
+    MatrixXd x(40, n + 1);
+    x.leftCols(n) = MatrixXd::Random(40, n);
+    x.col(n).setOnes();
+    VectorXd y = VectorXd::Random(40);
+    DataMoments moments(x, y);
+    CombinationsRange range(n, k);
+    IncrementalCholesky walk;
+    VectorU16 comb;
+    for (uint64_t i = 0; i < range.size(); ++i) {
+        range.combination(i, comb);
+        IncrementalCholesky fresh;
+        for (auto col : comb)
+            fresh.append(moments, col);
+        ASSERT_TRUE(walk.coeffs(moments, comb) == fresh.coeffs()) << "[ TEST_MSG ]: wrong coefficients of combination " << i;
+        VectorXd expected = x(Eigen::all, comb).colPivHouseholderQr().solve(y);
+        ASSERT_TRUE(fresh.coeffs().isApprox(expected, 1e-8));
+    }
+}
+
+TEST(testIncrementalCholesky, testFixedWidthCoeffs) {
+    MatrixXd x = MatrixXd::Random(50, 9);
+    x.col(5) = x.col(1) - x.col(3) * 0.5;
+    VectorXd y = VectorXd::Random(50);
+    DataMoments moments(x, y);
+    VectorU16 comb{ 4, 1, 3, 0, 5, 8, 2, 6 };
+    for (auto width = 2; width <= 8; ++width) {
+        VectorU16 cols(comb.begin(), comb.begin() + width);
+        VectorXd fixed;
+        switch (width) {
+        case 2: fixed = fixedCholeskyCoeffs<2>(moments, cols); break;
+        case 3: fixed = fixedCholeskyCoeffs<3>(moments, cols); break;
+        case 4: fixed = fixedCholeskyCoeffs<4>(moments, cols); break;
+        case 5: fixed = fixedCholeskyCoeffs<5>(moments, cols); break;
+        case 6: fixed = fixedCholeskyCoeffs<6>(moments, cols); break;
+        case 7: fixed = fixedCholeskyCoeffs<7>(moments, cols); break;
+        case 8: fixed = fixedCholeskyCoeffs<8>(moments, cols); break;
+        }
+        IncrementalCholesky cholesky;
+        for (auto col : cols)
+            cholesky.append(moments, col);
+        ASSERT_TRUE(fixed == cholesky.coeffs()) << "[ TEST_MSG ]: wrong coefficients of width " << width;
+    }
+}
+
+TEST(testIncrementalCholesky, testBatchedCoeffs) {
+    std::vector<DataMoments> moments;
+    for (auto lane = 0; lane < BATCHSIZE - 1; ++lane) { // the last lane of the batch stays unused
+        MatrixXd x = MatrixXd::Random(40, 6);
+        if (lane % 2 == 1)
+            x.col(lane % 5 + 1) = x.col(0) * 2 - x.col(lane % 5);
+        moments.emplace_back(x, VectorXd::Random(40));
+    }
+    std::vector<const DataMoments*> batch;
+    for (const auto& m : moments)
+        batch.push_back(&m);
+    std::vector<VectorXd> coeffs(BATCHSIZE);
+    batchedCholeskyCoeffs<6>(batch.data(), static_cast<int>(batch.size()), coeffs.data());
+    VectorU16 cols{ 0, 1, 2, 3, 4, 5 };
+    for (size_t lane = 0; lane < batch.size(); ++lane)
+        ASSERT_TRUE(coeffs[lane].isApprox(fixedCholeskyCoeffs<6>(moments[lane], cols), 1e-10)) 
+            << "[ TEST_MSG ]: wrong coefficients of the batch model " << lane;
+    double rss[BATCHSIZE];
+    batchedResidualsSquares<6>(batch.data(), static_cast<int>(batch.size()), coeffs.data(), rss);
+    for (size_t lane = 0; lane < batch.size(); ++lane)
+        EXPECT_NEAR(rss[lane], moments[lane].residualsSquare(cols, coeffs[lane]), 1e-10) 
+            << "[ TEST_MSG ]: wrong residual sum of squares of the batch model " << lane;
+}
+
+TEST(testIncrementalCholesky, testLeverages) {
+    MatrixXd x = randomData(20, 4);
+    x.col(3) = x.col(0) - x.col(1);
+    VectorXd y = randomData(20, 1, 1).col(0);
+    DataMoments moments(x, y);
+    IncrementalCholesky cholesky;
+    for (auto col = 0; col < 4; ++col)
+        cholesky.append(moments, col);
+    VectorXd leverages = cholesky.leverages(x), coeffs = cholesky.coeffs();
+    MatrixXd independent = x.leftCols(3);
+    MatrixXd hat = independent * (independent.transpose() * independent).inverse() * independent.transpose();
+    EXPECT_TRUE(leverages.isApprox(hat.diagonal(), 1e-10));
+    for (auto row = 0; row < 20; ++row) { // the leave-one-out residual is the residual divided by 1 - h
+        MatrixXd xRest(19, 3);
+        VectorXd yRest(19);
+        xRest << independent.topRows(row), independent.bottomRows(19 - row);
+        yRest << y.head(row), y.tail(19 - row);
+        auto expected = y[row] - independent.row(row).dot(xRest.colPivHouseholderQr().solve(yRest));
+        EXPECT_NEAR((y[row] - x.row(row).dot(coeffs)) / (1 - leverages[row]), expected, 1e-10);
+    }
+}
+
+TEST(testSplittedMoments, testFolds) {
+    MatrixXd xTrain = MatrixXd::Random(23, 4), xTest = MatrixXd::Random(14, 4);
+    VectorXd yTrain = VectorXd::Random(23), yTest = VectorXd::Random(14);
+    SplittedMoments moments(xTrain, xTest, yTrain, yTest), foldsMoments(xTrain, xTest, yTrain, yTest, 5);
+    ASSERT_EQ(foldsMoments.folds.size(), 5);
+    EXPECT_TRUE(foldsMoments.train.xx.isApprox(moments.train.xx, 1e-12));
+    EXPECT_TRUE(foldsMoments.test.xy.isApprox(moments.test.xy, 1e-12));
+    MatrixXd xAll(37, 4);
+    xAll << xTrain, xTest;
+    VectorXd yAll(37);
+    yAll << yTrain, yTest;
+    VectorU16 comb{ 3, 0, 2 }, cols{ 0, 1, 2 };
+    int64_t rows = 0;
+    for (const auto& fold : foldsMoments.folds) { // the coefficients of each fold are trained on the other rows
+        MatrixXd xRest(37 - fold.rows, 3);
+        VectorXd yRest(37 - fold.rows);
+        xRest << xAll(seqN(0, rows), comb), xAll(seq(rows + fold.rows, last), comb);
+        yRest << yAll.head(rows), yAll.tail(37 - rows - fold.rows);
+        VectorXd expected = xRest.colPivHouseholderQr().solve(yRest);
+        EXPECT_TRUE(fixedCholeskyCoeffs<3>(foldsMoments.all.difference(fold, comb), cols).isApprox(expected, 1e-10));
+        rows += fold.rows;
+    }
+    EXPECT_EQ(rows, 37);
+}
+
+TEST(testChunksReader, testFileChunks) {
+    MatrixXd x = randomData(23, 3);
+    VectorXd y = randomData(23, 1, 1).col(0);
+    writeChunksFile("gtest_chunks.bin", x, y);
+    {
+        FileChunksReader fileReader("gtest_chunks.bin", 3, 10);
+        auto memoryReader{ memoryChunksReader(x, y, 7) };
+        for (ChunksReader* reader : std::vector<ChunksReader*>{ &fileReader, &memoryReader }) {
+            int64_t rows;
+            int cols;
+            reader->getShape(rows, cols);
+            EXPECT_EQ(rows, 23);
+            EXPECT_EQ(cols, 3);
+            for (auto pass = 0; pass < 2; ++pass) {
+                MatrixXd xChunk;
+                VectorXd yChunk;
+                Index row{ 0 };
+                reader->rewind();
+                while (reader->read(xChunk, yChunk)) {
+                    ASSERT_LE(row + xChunk.rows(), 23);
+                    EXPECT_EQ(xChunk, x.middleRows(row, xChunk.rows()));
+                    EXPECT_EQ(yChunk, y.segment(row, xChunk.rows()));
+                    row += xChunk.rows();
+                }
+                EXPECT_EQ(row, 23);
+            }
+        }
+    }
+    auto readChunks{ 0 };
+    CallbackChunksReader shapeReader([]() {}, [&](MatrixXd& xChunk, VectorXd& yChunk) { // the chunks are endless
+        xChunk = x.topRows(7);
+        yChunk = y.head(7);
+        ++readChunks;
+        return true;
+    }, 23);
+    int64_t rows;
+    int cols;
+    shapeReader.getShape(rows, cols);
+    EXPECT_EQ(rows, 23);
+    EXPECT_EQ(cols, 3);
+    EXPECT_EQ(readChunks, 1) << "[ TEST_MSG ]: the given number of rows must not be counted";
+    EXPECT_THROW(FileChunksReader("gtest_chunks.bin", 4), FileException);
+    EXPECT_THROW(FileChunksReader("gtest_chunks.bin", 0), std::invalid_argument);
+    EXPECT_THROW(FileChunksReader("gtest_missing_chunks.bin", 3), FileException);
+    std::remove("gtest_chunks.bin");
+}
+
+TEST(testIncrementalQR, testColumnsAppend) {
+    MatrixXd x = MatrixXd::Random(30, 5);
+    x.col(2) = x.col(0) * 2 - x.col(1);
+    VectorXd y = VectorXd::Random(30);
+    IncrementalQR qr;
+    VectorU16 parent{ 0, 1, 3 };
+    for (auto col : parent)
+        EXPECT_TRUE(qr.append(x, y, col));
+    VectorXd expected = x(Eigen::all, VectorU16({ 0, 1, 3, 4 })).colPivHouseholderQr().solve(y);
+    EXPECT_TRUE(qr.coeffs(x, y, VectorU16({ 0, 1, 3, 4 })).isApprox(expected, 1e-8));
+    EXPECT_EQ(qr.size(), 3) << "[ TEST_MSG ]: the parent columns must remain after the solution";
+    VectorXd coeffs = qr.coeffs(x, y, VectorU16({ 0, 1, 3, 2 }));
+    EXPECT_EQ(coeffs[3], 0) << "[ TEST_MSG ]: linearly dependent column is included";
+    expected = x(Eigen::all, parent).colPivHouseholderQr().solve(y);
+    EXPECT_TRUE(coeffs.head(3).isApprox(expected, 1e-8));
+}
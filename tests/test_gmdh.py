@@ -4,6 +4,7 @@ All tests for gmdh module.
 
 #pylint: disable=invalid-name
 
+import threading
 import pytest # pylint: disable=import-error
 import numpy as np
 import gmdh  #pylint: disable=import-error
@@ -23,6 +24,14 @@ def models():
     """Returns all models of gmdh module"""
     return [gmdh.Combi, gmdh.Multi, gmdh.Mia, gmdh.Ria]
 
+@pytest.fixture
+def random_data():
+    """Returns the random data whose target depends on three of eight columns"""
+    generator = np.random.default_rng(0)
+    X = generator.uniform(-1, 1, (80, 8))
+    y = X[:, 1] * 3 + X[:, 4] - X[:, 6] * 0.5 + generator.uniform(-1, 1, 80) * 0.1
+    return X, y
+
 class TestDataPreparations:
     """
     Class containing methods for testing gmdh module functions
@@ -289,3 +298,92 @@ class TestModels:
         for model in models:
             with pytest.raises(ValueError):
                 model().fit(X=[[0, 1, 2], [3, 3.5, 4], [5, 6, 7]], y=[np.nan, 9, 10])
+
+class TestFitting:
+    """
+    Class containing methods for testing the fitting processes of gmdh models
+    that release the GIL and call the python functions.
+    """
+    # pylint: disable=redefined-outer-name
+
+    def test_concurrent_fits(self, random_data):
+        """
+        Testing the fitting of Combi models started by several python threads on the same executor.
+        Expected result is the same model as the one fitted alone.
+        """
+        X, y = random_data
+        criterion = gmdh.Criterion(gmdh.CriterionType.REGULARITY, gmdh.Solver.GRAM)
+        expected = gmdh.Combi().fit(X, y, criterion).get_best_polynomial()
+        executor = gmdh.Executor(n_jobs=2)
+        polynomials = [None] * 4
+        def fit(i):
+            polynomials[i] = gmdh.Combi().fit(X, y, criterion, n_jobs=-1, executor=executor).get_best_polynomial()
+        threads = [threading.Thread(target=fit, args=(i,)) for i in range(len(polynomials))]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        assert polynomials == [expected] * len(polynomials)
+
+    def test_raising_callback(self, random_data):
+        """
+        Testing the progress callback raising an exception.
+        Expected result is the exception passed from the fitting and the model fitted again after it.
+        """
+        X, y = random_data
+        model = gmdh.Combi()
+        def callback(info):
+            if info.level_completed:
+                raise RuntimeError('callback error')
+        model.set_progress_callback(callback)
+        with pytest.raises(RuntimeError, match='callback error'):
+            model.fit(X, y, n_jobs=2)
+        model.set_progress_callback(None)
+        assert model.fit(X, y, n_jobs=2).get_best_polynomial() == gmdh.Combi().fit(X, y).get_best_polynomial()
+
+    def test_token_deadline(self, random_data):
+        """
+        Testing the fitting stopped by the expired time limit of the cancellation token.
+        Expected result is the truncated model built from the evaluated combinations of the first level.
+        """
+        X, y = random_data
+        model = gmdh.Combi()
+        token = gmdh.CancellationToken(time_limit=0)
+        assert token.is_cancelled()
+        model.fit(X, y, gmdh.Criterion(gmdh.CriterionType.REGULARITY, gmdh.Solver.GRAM), n_jobs=2, token=token)
+        report = model.get_fit_report()
+        assert report.truncated
+        assert len(report.evaluated_combinations) == 1
+        assert model.predict(X).shape == y.shape
+        with pytest.raises(ValueError):
+            gmdh.CancellationToken(time_limit=-2)
+
+    @pytest.mark.parametrize('n_rows', [None, 80])
+    def test_callback_chunks_reader(self, random_data, n_rows):
+        """
+        Testing the fitting on the chunks produced by a python generator with and without the given number of rows.
+        Expected result is the same model as the one fitted on all rows.
+        """
+        X, y = random_data
+        criterion = gmdh.Criterion(gmdh.CriterionType.REGULARITY, gmdh.Solver.GRAM)
+        reader = gmdh.CallbackChunksReader(lambda: ((X[i:i + 7], y[i:i + 7]) for i in range(0, len(X), 7)), n_rows)
+        for model_class in [gmdh.Combi, gmdh.Mia]:
+            expected = model_class().fit(X, y, criterion)
+            model = model_class().fit_chunks(reader, criterion)
+            assert model.get_best_polynomial() == expected.get_best_polynomial()
+            assert np.allclose(model.predict(X), expected.predict(X))
+
+    def test_partial_fit_expired_rows(self, random_data):
+        """
+        Testing the sliding window of Combi model appending the new rows and removing the expired ones.
+        Expected result is the same model as the one fitted on the rows of the window.
+        """
+        X, y = random_data
+        model = gmdh.Combi()
+        model.partial_fit(X[:30], y[:30])
+        model.partial_fit(X[30:60], y[30:60])
+        model.partial_fit(X[60:], y[60:], expired_X=X[:20], expired_y=y[:20])
+        window_model = gmdh.Combi().partial_fit(X[20:], y[20:])
+        assert np.allclose(model.predict(X), window_model.predict(X))
+        with pytest.raises(ValueError):
+            model.partial_fit(X[60:], y[60:], expired_X=X[:20])
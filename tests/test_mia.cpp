@@ -35,6 +35,96 @@ TEST_F(TestMIA, testPrediction) {
     EXPECT_TRUE(errorMsg.empty()) << errorMsg;
 }
 
+TEST_F(TestMIA, testGramSolver) {
+    auto testData = getTestData();
+    static_cast<MIA*>(testModel)->fit(testData.dataValues.xTrain, testData.dataValues.yTrain, 
+                                      Criterion(CriterionType::regularity, Solver::gram));
+    auto errorMsg = testPredict(testData.dataValues.xTest, testData.realPredValues);
+    EXPECT_TRUE(errorMsg.empty()) << errorMsg;
+}
+
+TEST_F(TestMIA, testPolynomialMoments) {
+    MatrixXd x = MatrixXd::Random(50, 4);
+    VectorXd y = VectorXd::Random(50);
+    MatrixXd xOnes(50, 3);
+    xOnes << x.col(3), x.col(1), VectorXd::Ones(50);
+    for (auto polynomialType : { PolynomialType::linear, PolynomialType::linear_cov, PolynomialType::quadratic }) {
+        PolynomialMoments moments(x.topRows(20), y.head(20), polynomialType);
+        moments += PolynomialMoments(x.bottomRows(30), y.tail(30), polynomialType);
+        MatrixXd xPolynomial = xOnes;
+        if (polynomialType == PolynomialType::linear_cov) {
+            xPolynomial.resize(50, 4);
+            xPolynomial << x.col(3), x.col(1), x.col(3).cwiseProduct(x.col(1)), VectorXd::Ones(50);
+        }
+        else if (polynomialType == PolynomialType::quadratic) {
+            xPolynomial.resize(50, 6);
+            xPolynomial << x.col(3), x.col(1), x.col(3).cwiseProduct(x.col(1)), x.col(3).cwiseAbs2(), 
+                           x.col(1).cwiseAbs2(), VectorXd::Ones(50);
+        }
+        DataMoments expected(xPolynomial, y);
+        auto pairMoments = moments.pairMoments(3, 1, polynomialType);
+        EXPECT_TRUE(pairMoments.xx.isApprox(expected.xx, 1e-12));
+        EXPECT_TRUE(pairMoments.xy.isApprox(expected.xy, 1e-12));
+        EXPECT_DOUBLE_EQ(pairMoments.yy, expected.yy);
+        EXPECT_EQ(pairMoments.rows, 50);
+    }
+}
+
+TEST_F(TestMIA, testGramSolverPolynomials) {
+    MatrixXd x = MatrixXd::Random(200, 5);
+    VectorXd y = x.col(0).cwiseProduct(x.col(2)) * 2 + x.col(4).cwiseAbs2() + VectorXd::Random(200) * 0.01;
+    MIA secondModel;
+    static_cast<MIA*>(testModel)->fit(x, y, Criterion(CriterionType::regularity, Solver::gram), 4);
+    secondModel.fit(x, y, Criterion(CriterionType::regularity, Solver::balanced), 4);
+    EXPECT_TRUE(testModel->predict(x).isApprox(secondModel.predict(x), 1e-8));
+}
+
+TEST_F(TestMIA, testFitChunks) {
+    MatrixXd x = randomData(200, 5);
+    VectorXd y = x.col(0).cwiseProduct(x.col(2)) * 2 + x.col(4).cwiseAbs2() + 
+                 randomData(200, 1, 1).col(0) * 0.01;
+    Criterion criterion(CriterionType::stability, Solver::gram);
+    static_cast<MIA*>(testModel)->fit(x, y, criterion, 4);
+    auto reader{ memoryChunksReader(x, y, 30) };
+    MIA chunksModel;
+    chunksModel.fitChunks(reader, criterion, 4);
+    EXPECT_EQ(chunksModel.getBestPolynomial(), testModel->getBestPolynomial());
+    EXPECT_TRUE(chunksModel.predict(x).isApprox(testModel->predict(x), 1e-8));
+    EXPECT_THROW(chunksModel.fitChunks(reader, criterion, 2), std::invalid_argument);
+}
+
+TEST_F(TestMIA, testSequentialCriterionGram) {
+    MatrixXd x = randomData(200, 5);
+    VectorXd y = x.col(0).cwiseProduct(x.col(2)) * 2 + x.col(4).cwiseAbs2() + 
+                 randomData(200, 1, 1).col(0) * 0.01;
+    MIA secondModel;
+    SequentialCriterion criterion(CriterionType::regularity, CriterionType::symUnbiasedOutputs, 0, Solver::gram);
+    static_cast<MIA*>(testModel)->fit(x, y, criterion, 4);
+    secondModel.fit(x, y, SequentialCriterion(CriterionType::regularity, CriterionType::symUnbiasedOutputs), 4);
+    EXPECT_TRUE(testModel->predict(x).isApprox(secondModel.predict(x), 1e-8));
+}
+
+TEST_F(TestMIA, testBatchedCriteria) {
+    MatrixXd x = randomData(200, 5);
+    VectorXd y = x.col(0).cwiseProduct(x.col(2)) * 2 + x.col(4).cwiseAbs2() + 
+                 randomData(200, 1, 1).col(0) * 0.01;
+    std::vector<CriterionType> criteria{ CriterionType::symStability, CriterionType::unbiasedCoeffs };
+    MIA secondModel;
+    static_cast<MIA*>(testModel)->setScoredCriteria(criteria);
+    secondModel.setScoredCriteria(criteria);
+    static_cast<MIA*>(testModel)->fit(x, y, ParallelCriterion(CriterionType::symRegularity, CriterionType::stability, 
+                                                              0.5, Solver::gram), 4);
+    secondModel.fit(x, y, ParallelCriterion(CriterionType::symRegularity, CriterionType::stability, 0.5, 
+                                            Solver::balanced), 4);
+    EXPECT_TRUE(testModel->predict(x).isApprox(secondModel.predict(x), 1e-8));
+    const auto& scores{ testModel->getFitReport().criteriaScores };
+    const auto& secondScores{ secondModel.getFitReport().criteriaScores };
+    ASSERT_FALSE(scores.empty());
+    ASSERT_EQ(scores.size(), secondScores.size());
+    for (size_t level = 0; level < scores.size(); ++level)
+        EXPECT_TRUE(scores[level].isApprox(secondScores[level], 1e-6)) << "at level " << level;
+}
+
 TEST_F(TestMIA, testSave) {
     auto testData = getTestData();
     static_cast<MIA*>(testModel)->fit(testData.dataValues.xTrain, testData.dataValues.yTrain);
@@ -52,4 +52,47 @@ TEST_F(TestMULTI, testGetBestPolinomial) {
     static_cast<MULTI*>(testModel)->fit(testData.dataValues.xTrain, testData.dataValues.yTrain);
     auto errorMsg = testGetBestPolinomial("");
     EXPECT_TRUE(errorMsg.empty()) << errorMsg;
+}
+
+TEST_F(TestMULTI, testParallelCombinationsGeneration) {
+    MatrixXd x = randomData(60, 9);
+    VectorXd y = x.col(0) * 2 - x.col(3) + x.col(7) * 0.5 + randomData(60, 1, 1).col(0) * 0.1;
+    MULTI secondModel;
+    static_cast<MULTI*>(testModel)->fit(x, y, Criterion(CriterionType::regularity), 10, 0.5, 1, 1);
+    secondModel.fit(x, y, Criterion(CriterionType::regularity), 10, 0.5, 1, 4);
+    EXPECT_EQ(testModel->getBestPolynomial(), secondModel.getBestPolynomial());
+}
+
+TEST_F(TestMULTI, testGramSolver) {
+    auto testData = getTestData();
+    static_cast<MULTI*>(testModel)->fit(testData.dataValues.xTrain, testData.dataValues.yTrain, 
+                                        Criterion(CriterionType::symRegularity, Solver::gram));
+    auto errorMsg = testPredict(testData.dataValues.xTest, testData.realPredValues);
+    EXPECT_TRUE(errorMsg.empty()) << errorMsg;
+}
+
+TEST_F(TestMULTI, testParentDecompositionsReuse) {
+    MatrixXd x = randomData(80, 10);
+    VectorXd y = x.col(1) * 2 - x.col(4) + x.col(8) * 0.5 + randomData(80, 1, 1).col(0) * 0.1;
+    MULTI qrModel, gramModel, fastModel;
+    for (auto i: allCriterionTypes) {
+        static_cast<MULTI*>(testModel)->fit(x, y, Criterion(i, Solver::balanced), 5);
+        qrModel.fit(x, y, Criterion(i, Solver::accurate), 5);
+        gramModel.fit(x, y, Criterion(i, Solver::gram), 5);
+        fastModel.fit(x, y, Criterion(i, Solver::fast), 5);
+        EXPECT_TRUE(fastModel.predict(x).isApprox(qrModel.predict(x), 1e-8)) << "with criterion #"+std::to_string(static_cast<int>(i));
+        EXPECT_TRUE(testModel->predict(x).isApprox(qrModel.predict(x), 1e-8)) << "with criterion #"+std::to_string(static_cast<int>(i));
+        EXPECT_TRUE(gramModel.predict(x).isApprox(qrModel.predict(x), 1e-8)) << "with criterion #"+std::to_string(static_cast<int>(i));
+    }
+}
+
+TEST_F(TestMULTI, testPartialFit) {
+    MatrixXd x = randomData(60, 8);
+    VectorXd y = x.col(2) * 2 + x.col(5) - x.col(7) * 0.5 + randomData(60, 1, 1).col(0) * 0.1;
+    Criterion criterion(CriterionType::stability, Solver::gram);
+    for (auto i = 0; i < 60; i += 15)
+        static_cast<MULTI*>(testModel)->partialFit(x.middleRows(i, 15), y.segment(i, 15), criterion, 3);
+    MULTI model;
+    model.partialFit(x, y, criterion, 3);
+    EXPECT_TRUE(testModel->predict(x).isApprox(model.predict(x), 1e-8));
 }
\ No newline at end of file
@@ -51,4 +51,17 @@ TEST_F(TestRIA, testGetBestPolinomial) {
     static_cast<RIA*>(testModel)->fit(testData.dataValues.xTrain, testData.dataValues.yTrain);
     auto errorMsg = testGetBestPolinomial("");
     EXPECT_TRUE(errorMsg.empty()) << errorMsg;
+}
+
+TEST_F(TestRIA, testFitChunks) {
+    MatrixXd x = randomData(200, 4);
+    VectorXd y = x.col(1).cwiseProduct(x.col(3)) - x.col(0) + 
+                 randomData(200, 1, 1).col(0) * 0.01;
+    Criterion criterion(CriterionType::regularity, Solver::gram);
+    static_cast<RIA*>(testModel)->fit(x, y, criterion, 2);
+    auto reader{ memoryChunksReader(x, y, 64) };
+    RIA chunksModel;
+    chunksModel.fitChunks(reader, criterion, 2);
+    EXPECT_EQ(chunksModel.getBestPolynomial(), testModel->getBestPolynomial());
+    EXPECT_TRUE(chunksModel.predict(x).isApprox(testModel->predict(x), 1e-8));
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #include "test_setup.h"
+#include <random>
 
-const CriterionType allCriterionTypes[9] = {CriterionType::regularity, CriterionType::symRegularity, CriterionType::stability, CriterionType::symStability, 
+const CriterionType allCriterionTypes[11] = {CriterionType::regularity, CriterionType::symRegularity, CriterionType::stability, CriterionType::symStability, 
                                             CriterionType::unbiasedOutputs, CriterionType::symUnbiasedOutputs, CriterionType::unbiasedCoeffs, 
-                                            CriterionType::absoluteNoiseImmunity, CriterionType::symAbsoluteNoiseImmunity};
+                                            CriterionType::absoluteNoiseImmunity, CriterionType::symAbsoluteNoiseImmunity, CriterionType::crossValidation, 
+                                            CriterionType::leaveOneOut};
 
 std::string TestGmdhModel::testSave() {
     GTEST_EXPECT_NO_DEATH({
@@ -152,6 +154,32 @@ TestGmdhModel::TestData TestGmdhModel::getTestDataFromFile() {
     return ::testing::AssertionSuccess();
 }
 
+void writeChunksFile(const std::string& path, const MatrixXd& x, const VectorXd& y) {
+    Matrix<double, Dynamic, Dynamic, RowMajor> rows(x.rows(), x.cols() + 1);
+    rows << x, y;
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(rows.data()), rows.size() * sizeof(double));
+}
+
+CallbackChunksReader memoryChunksReader(const MatrixXd& x, const VectorXd& y, Index chunkRows) {
+    auto nextRow{ std::make_shared<Index>(0) };
+    return CallbackChunksReader([nextRow]() { *nextRow = 0; }, [&x, &y, chunkRows, nextRow](MatrixXd& xChunk, VectorXd& yChunk) {
+        if (*nextRow >= x.rows())
+            return false;
+        auto rows{ std::min(chunkRows, x.rows() - *nextRow) };
+        xChunk = x.middleRows(*nextRow, rows);
+        yChunk = y.segment(*nextRow, rows);
+        *nextRow += rows;
+        return true;
+    });
+}
+
+MatrixXd randomData(Index rows, Index cols, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    return MatrixXd::NullaryExpr(rows, cols, [&]() { return distribution(generator); });
+}
+
 int main(int argc, char *argv[])
 {
 	::testing::InitGoogleTest(&argc, argv);
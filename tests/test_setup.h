@@ -9,7 +9,7 @@
 using namespace GMDH;
 using namespace Eigen;
 
-extern const CriterionType allCriterionTypes[9];
+extern const CriterionType allCriterionTypes[11];
 
 class TestGmdhModel : public ::testing::Test
 {
@@ -52,4 +52,10 @@ public:
     static bool SKIP_FIXTURES;
 }; // TODO: solution matrix on tests result
 
-::testing::AssertionResult PredictionEvaluation(VectorXd predict, VectorXd real, int precision);
\ No newline at end of file
+::testing::AssertionResult PredictionEvaluation(VectorXd predict, VectorXd real, int precision);
+
+void writeChunksFile(const std::string& path, const MatrixXd& x, const VectorXd& y);
+
+CallbackChunksReader memoryChunksReader(const MatrixXd& x, const VectorXd& y, Index chunkRows);
+
+MatrixXd randomData(Index rows, Index cols, unsigned seed = 0);
\ No newline at end of file